@@ -20,4 +20,48 @@ ei_surface_t g_offscreen;
  */
 extern ei_widgetclass_t* get_linked_list_classes();
 
+/**
+ * @brief       Add a rectangle to the region of the picking offscreen which must be drawn again, because the
+ *              geometry of the widgets (location, size, shape or stacking order) has changed there.
+ *              The offscreen is only updated when a widget is picked, see \ref update_pick_offscreen.
+ *
+ * @param       rect        The rectangle, expressed in the root window coordinates.
+ */
+void invalidate_geometry_rect(ei_rect_t *rect);
+
+/**
+ * @brief       Draw again the invalidated region of the picking offscreen, only if the geometry of the widgets
+ *              has changed since the last update.
+ */
+void update_pick_offscreen(void);
+
+/**
+ * @brief       Update the window after a widget has been moved without changing its size nor its appearance, and
+ *              without invalidating its locations. The pixels of the widget which are visible on the window are
+ *              copied to its new location. Only the region it has uncovered, the parts of its new location which
+ *              were not visible before, and the widgets drawn over it are drawn again.
+ *              The widget must be opaque on its whole screen location, as the toplevels are.
+ *
+ * @param       widget          The widget, its screen location is the new one
+ * @param       old_location    The screen location of the widget before it was moved
+ */
+void move_widget_pixels(ei_widget_t *widget, ei_rect_t old_location);
+
+/**
+ * @brief       Move a placed widget to a new absolute position, without changing its size nor its appearance.
+ *              Its pixels are copied on the window to the new location instead of being drawn again, see
+ *              \ref move_widget_pixels. It is implemented by the placer.
+ *
+ * @param       widget      The widget, it must be opaque on its whole screen location
+ * @param       x           The absolute x position of the widget
+ * @param       y           The absolute y position of the widget
+ */
+void move_placed_widget(ei_widget_t *widget, int x, int y);
+
+/**
+ * @brief       Free the memory used to queue the widgets of the layout transactions (see \ref ei_layout_begin).
+ *              It is implemented by the placer.
+ */
+void layout_release(void);
+
 #endif //PROJETC_IG_APPLICATION_H
@@ -0,0 +1,42 @@
+#ifndef PROJETC_IG_CLASS_REGISTRY_H
+#define PROJETC_IG_CLASS_REGISTRY_H
+
+#include <stdint.h>
+
+#include "ei_widgetclass.h"
+
+// Ids of the classes of the library, ei_app_create registers them first and in this order
+#define CLASS_ID_FRAME 1
+#define CLASS_ID_TOPLEVEL 2
+#define CLASS_ID_BUTTON 3
+
+// Initial number of slots of the hash table of classes, a power of two
+#define CLASS_REGISTRY_INITIAL_SIZE 16
+
+/**
+ * @brief       Store a class in the hash table indexed by its name, and give it an id. The ids are given
+ *              in the registration order, starting at 1. If a class of the same name was registered
+ *              before, it is replaced and its id is kept.
+ *
+ * @param       widgetclass     The class
+ *
+ * @return      The id of the class.
+ */
+uint32_t class_registry_add(ei_widgetclass_t *widgetclass);
+
+/**
+ * @brief       Return the class which has a name.
+ *
+ * @param       name        The name of the class
+ *
+ * @return      The class, or NULL if no class has this name.
+ */
+ei_widgetclass_t *class_registry_find(const char *name);
+
+/**
+ * @brief       Free the memory used by the hash table. The classes themselves are not freed, and the
+ *              next id is 1 again.
+ */
+void class_registry_release(void);
+
+#endif //PROJETC_IG_CLASS_REGISTRY_H
@@ -18,6 +18,9 @@
 
 
 
+// Default minimum time between two frames, in seconds (60 frames per second)
+#define EI_DEFAULT_FRAME_INTERVAL (1.0 / 60.0)
+
 /**
  * \brief	Creates an application.
  *		<ul>
@@ -58,6 +61,22 @@ void ei_app_run(void);
  */
 void ei_app_invalidate_rect(ei_rect_t* rect);
 
+/**
+ * \brief	Asks for a new frame. The regions given to \ref ei_app_invalidate_rect are drawn, or the
+ *		whole window if there is none. Frames are drawn at most once per frame interval (see
+ *		\ref ei_app_set_frame_interval), and never when nothing has been invalidated or requested.
+ */
+void ei_app_request_redraw(void);
+
+/**
+ * \brief	Sets the minimum time between two frames. The events received meanwhile are treated,
+ *		and their damaged regions are drawn together in the next frame.
+ *
+ * @param	interval	The interval, in seconds. Defaults to \ref EI_DEFAULT_FRAME_INTERVAL.
+ *				With 0, a frame is drawn after each event which damaged the window.
+ */
+void ei_app_set_frame_interval(double interval);
+
 /**
  * \brief	Tells the application to quite. Is usually called by an event handler (for example
  *		when pressing the "Escape" key).
@@ -80,6 +99,23 @@ ei_widget_t* ei_app_root_widget(void);
  */
 ei_surface_t ei_app_root_surface(void);
 
+/**
+ * \brief	Returns the number of mouse move events which were not treated because a more recent
+ *		mouse move was already waiting in the event queue. Only the last position of a run of
+ *		mouse moves is treated, the buttons pressed and released in between are kept.
+ *
+ * @return			The number of coalesced events since the application was created.
+ */
+uint32_t ei_app_coalesced_events(void);
+
+/**
+ * \brief	Releases what the library keeps about a font. It must be called before the font is
+ *		freed by \ref hw_text_font_free, since a font created later may get the same address.
+ *
+ * @param	font		The font which is going to be freed.
+ */
+void ei_app_forget_font(ei_font_t font);
+
 
 
 
@@ -16,6 +16,15 @@ typedef enum {
         FULL            = 2
 } ei_part_frame;
 
+// Maximum number of segments of a bow, its number of segments depends on its radius
+#define ARC_MAX_SEGMENTS 64
+
+// Maximum number of points of a rectangle with rounded edges, including the closing point
+#define ROUNDED_FRAME_MAX_POINTS (4 * (ARC_MAX_SEGMENTS + 1) + 1)
+
+// Maximum number of cached rectangles with rounded edges, they are all forgotten when it is reached
+#define ROUNDED_FRAME_CACHE_SIZE 1024
+
 /**
  * @brief       Generate a linked list of points which represent a bow.
  *              The linked list is malloc so it must be free by the user of this function.
@@ -47,6 +56,29 @@ ei_linked_point_t*       rounded_frame           (ei_rect_t              rectang
                                                  uint32_t                rounded_radius,
                                                  ei_part_frame           part);
 
+/**
+ * @brief       Same as \ref rounded_frame, but the points are written in an array given by the caller,
+ *              so that nothing is allocated. The shape of each (size, radius, part) is computed once,
+ *              then it is only translated to the position of the rectangle.
+ *
+ * @param       rectangle           The rectangle (size and top-left position) which must be rounded.
+ * @param       rounded_radius      The radius of roundings.
+ * @param       part                The part of rectangle which must be generated.
+ * @param       points              The array where the points are written, the last one is the same as
+ *                                  the first one. It must contain at least \ref ROUNDED_FRAME_MAX_POINTS points.
+ *
+ * @return      The number of written points.
+ */
+uint32_t                rounded_frame_cached    (ei_rect_t              rectangle,
+                                                 uint32_t                rounded_radius,
+                                                 ei_part_frame           part,
+                                                 ei_point_t*             points);
+
+/**
+ * @brief       Forget all the shapes computed by \ref rounded_frame_cached.
+ */
+void rounded_frame_cache_release(void);
+
 /**
  * @brief       Return the last point of a single linked list.
  *
@@ -73,6 +105,14 @@ void free_list(ei_linked_point_t *lc);
  */
 ei_linked_point_t *get_rectangle_list (ei_rect_t          rectangle);
 
+/**
+ * @brief       Same as \ref get_rectangle_list, but the points are written in an array given by the caller.
+ *
+ * @param       rectangle       The rectangle (size and top-left position) which must be generated.
+ * @param       points          The array where the 5 points are written, the last one is the same as the first one.
+ */
+void rectangle_points (ei_rect_t rectangle, ei_point_t *points);
+
 
 
 #endif //PROJETC_IG_BUTTON_H
@@ -51,6 +51,23 @@ void			ei_draw_polyline	(ei_surface_t			surface,
 						 ei_color_t			color,
 						 const ei_rect_t*		clipper);
 
+/**
+ * \brief	Same as \ref ei_draw_polyline, but the points are given in an array.
+ *		It avoids building a linked list when the points are already contiguous.
+ *
+ * @param	surface 	Where to draw the line. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	points	 	The points of the polyline.
+ * @param	nb_points	The number of points. It can be 0 (i.e. draws nothing), 1, or more.
+ * @param	color		The color used to draw the line. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void			ei_draw_polyline_n	(ei_surface_t			surface,
+						 const ei_point_t*		points,
+						 uint32_t			nb_points,
+						 ei_color_t			color,
+						 const ei_rect_t*		clipper);
+
 /**
  * \brief	Draws a filled polygon.
  *
@@ -68,6 +85,24 @@ void			ei_draw_polygon		(ei_surface_t			surface,
 						 ei_color_t			color,
 						 const ei_rect_t*		clipper);
 
+/**
+ * \brief	Same as \ref ei_draw_polygon, but the points are given in an array.
+ *		It avoids building a linked list when the points are already contiguous.
+ *
+ * @param	surface 	Where to draw the polygon. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	points	 	The points of the polygon. The last point is implicitly connected
+ *				to the first point.
+ * @param	nb_points	The number of points. It is either 0 (i.e. draws nothing), or more than 2.
+ * @param	color		The color used to draw the polygon. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void			ei_draw_polygon_n	(ei_surface_t			surface,
+						 const ei_point_t*		points,
+						 uint32_t			nb_points,
+						 ei_color_t			color,
+						 const ei_rect_t*		clipper);
+
 /**
  * \brief	Draws text by calling \ref hw_text_create_surface.
  *
@@ -101,6 +136,21 @@ void			ei_fill			(ei_surface_t		surface,
 						 const ei_color_t*	color,
 						 const ei_rect_t*	clipper);
 
+/**
+ * \brief	Fills several rectangles of the surface with the specified color.
+ *		The surface is locked only once for all the rectangles.
+ *
+ * @param	surface		The surface to be filled. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	color		The color used to fill the rectangles. If NULL, it means that the
+ *				caller want it painted black (opaque).
+ * @param	rects		The head of a linked list of the rectangles to fill. It can be NULL
+ *				(i.e. fills nothing).
+ */
+void			ei_fill_rects		(ei_surface_t			surface,
+						 const ei_color_t*		color,
+						 const ei_linked_rect_t*	rects);
+
 
 /**
  * \brief	Copies pixels from a source surface to a destination surface.
@@ -117,7 +167,9 @@ void			ei_fill			(ei_surface_t		surface,
  *				rectangle on the source surface from which to copy the pixels.
  * @param	alpha		If true, the final pixels are a combination of source and
  *				destination pixels weighted by the source alpha channel and
- *				the transparency of the final pixels is set to opaque.
+ *				the transparency of the final pixels is set to opaque, except
+ *				where a fully transparent source pixel is copied on a fully
+ *				transparent destination pixel, which is left unchanged.
  *				If false, the final pixels are an exact copy of the source pixels,
  				including the alpha channel.
  *
@@ -129,5 +181,23 @@ int			ei_copy_surface		(ei_surface_t		destination,
 						 const ei_rect_t*	src_rect,
 						 ei_bool_t		alpha);
 
+/**
+ * \brief	Copies pixels inside a surface, from a rectangle to another one of the same size.
+ *		Unlike \ref ei_copy_surface, the two rectangles may overlap: the result is the same
+ *		as if the source pixels were saved before being copied. Used to move a part of the
+ *		window without drawing it again.
+ *		The surface must be *locked* by \ref hw_surface_lock.
+ *
+ * @param	surface		The surface in which to copy pixels.
+ * @param	dst_rect	The rectangle on the surface where to copy the pixels.
+ * @param	src_rect	The rectangle on the surface from which to copy the pixels.
+ *
+ * @return			Returns 0 on success, 1 on failure (different sizes between the rectangles,
+ *				or a rectangle which is not inside the surface).
+ */
+int			ei_copy_surface_overlap	(ei_surface_t		surface,
+						 const ei_rect_t*	dst_rect,
+						 const ei_rect_t*	src_rect);
+
 
 #endif
@@ -47,6 +47,11 @@ typedef struct ei_placer_params_t {
 	float			rw_data;
 	float*			rh;		///< The requested relative height.
 	float			rh_data;
+
+	ei_bool_t		is_dirty;		///< The parameters have changed since the last computation of the geometry, other than the position only.
+	ei_rect_t		parent_content_rect;	///< Content rect of the parent used by the last computation of the geometry.
+	ei_bool_t		is_queued;		///< The widget waits for the commit of a layout transaction (see \ref ei_layout_begin).
+	uint32_t		layout_stamp;		///< Number of the last commit which computed the geometry.
 } ei_placer_params_t;
 
 
@@ -101,11 +106,31 @@ void		ei_place	(struct ei_widget_t*	widget,
  *		The widget must have been previsouly placed by a call to \ref ei_place.
  *		Geometry re-computation is necessary for example when the text label of
  *		a widget has changed, and thus the widget "natural" size has changed.
+ *		The descendants are recomputed only if the content rect they are placed in has
+ *		changed, and the subtrees whose geometry is unchanged are not visited.
+ *
+ * 		During a layout transaction, the computation is delayed until the commit.
  *
  * @param	widget		The widget which geometry must be re-computed.
  */
 void ei_placer_run(struct ei_widget_t* widget);
 
+/**
+ * \brief	Opens a layout transaction: the geometry of the widgets given to \ref ei_place and
+ *		\ref ei_placer_run is not computed until \ref ei_layout_commit is called, so a widget
+ *		configured several times is placed only once. Their screen location is not updated
+ *		meanwhile, so it must not be read before the commit. Transactions can be nested,
+ *		only the outermost commit places the widgets.
+ */
+void ei_layout_begin(void);
+
+/**
+ * \brief	Closes a layout transaction opened by \ref ei_layout_begin. If it is the outermost one,
+ *		the queued widgets are placed, parents before children, and each widget is notified
+ *		of its new geometry at most once.
+ */
+void ei_layout_commit(void);
+
 
 
 /**
@@ -158,6 +158,52 @@ static inline ei_rect_t ei_rect(ei_point_t top_left, ei_size_t size)
 	return r;
 }
 
+/**
+ * @brief	Returns EI_TRUE if the rectangle passed as parameter doesn't contain any pixel.
+ */
+static inline ei_bool_t ei_rect_is_empty(ei_rect_t rect)
+{
+	return (ei_bool_t)(rect.size.width <= 0 || rect.size.height <= 0);
+}
+
+/**
+ * @brief	Returns the intersection of the two rectangles passed as parameters.
+ *		If they don't overlap, the returned rectangle has a size of (0, 0).
+ */
+static inline ei_rect_t ei_rect_intersection(ei_rect_t r1, ei_rect_t r2)
+{
+	int		x_min	= r1.top_left.x > r2.top_left.x ? r1.top_left.x : r2.top_left.x;
+	int		y_min	= r1.top_left.y > r2.top_left.y ? r1.top_left.y : r2.top_left.y;
+	int		x_max1	= r1.top_left.x + r1.size.width;
+	int		x_max2	= r2.top_left.x + r2.size.width;
+	int		y_max1	= r1.top_left.y + r1.size.height;
+	int		y_max2	= r2.top_left.y + r2.size.height;
+	int		x_max	= x_max1 < x_max2 ? x_max1 : x_max2;
+	int		y_max	= y_max1 < y_max2 ? y_max1 : y_max2;
+
+	if (x_max <= x_min || y_max <= y_min)
+		return ei_rect(ei_point(x_min, y_min), ei_size_zero());
+	return ei_rect(ei_point(x_min, y_min), ei_size(x_max - x_min, y_max - y_min));
+}
+
+/**
+ * @brief	Returns the smallest rectangle which contains the two rectangles passed as
+ *		parameters.
+ */
+static inline ei_rect_t ei_rect_union(ei_rect_t r1, ei_rect_t r2)
+{
+	int		x_min	= r1.top_left.x < r2.top_left.x ? r1.top_left.x : r2.top_left.x;
+	int		y_min	= r1.top_left.y < r2.top_left.y ? r1.top_left.y : r2.top_left.y;
+	int		x_max1	= r1.top_left.x + r1.size.width;
+	int		x_max2	= r2.top_left.x + r2.size.width;
+	int		y_max1	= r1.top_left.y + r1.size.height;
+	int		y_max2	= r2.top_left.y + r2.size.height;
+	int		x_max	= x_max1 > x_max2 ? x_max1 : x_max2;
+	int		y_max	= y_max1 > y_max2 ? y_max1 : y_max2;
+
+	return ei_rect(ei_point(x_min, y_min), ei_size(x_max - x_min, y_max - y_min));
+}
+
 
 
 
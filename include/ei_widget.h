@@ -17,6 +17,7 @@
 
 
 struct ei_placer_params_t;
+struct ei_render_cache_t;
 
 /**
  * @brief	The type of functions that are called just before a widget is being destroyed
@@ -36,6 +37,7 @@ typedef struct ei_widget_t {
 	ei_widgetclass_t*	wclass;		///< The class of widget of this widget. Avoids the field name "class" which is a keyword in C++.
 	uint32_t		pick_id;	///< Id of this widget in the picking offscreen.
 	ei_color_t*		pick_color;	///< pick_id encoded as a color.
+	ei_color_t		pick_color_data;///< Storage of pick_color, so that it is not allocated alone.
 	void*			user_data;	///< Pointer provided by the programmer for private use. May be NULL.
 	ei_widget_destructor_t	destructor;	///< Pointer to the programmer's function to call before destroying this widget. May be NULL.
 
@@ -44,12 +46,22 @@ typedef struct ei_widget_t {
 	struct ei_widget_t*	children_head;	///< Pointer to the first child of this widget.	Children are chained with the "next_sibling" field.
 	struct ei_widget_t*	children_tail;	///< Pointer to the last child of this widget.
 	struct ei_widget_t*	next_sibling;	///< Pointer to the next child of this widget's parent widget.
+	struct ei_widget_t*	prev_sibling;	///< Pointer to the previous child of this widget's parent widget.
+	int64_t			stacking_key;	///< Increases along the list of children of the parent, so that two siblings are ordered without going through the list.
 
 	/* Geometry Management */
 	ei_placer_params_t*	placer_params;	///< Pointer to the placer parameters for this widget. If NULL, the widget is not currently managed and thus, is not displayed on the screen.
 	ei_size_t		requested_size;	///< Size requested by the widget (big enough for its label, for example), or by the programmer. This can be different than its screen size defined by the placer.
 	ei_rect_t		screen_location;///< Position and size of the widget expressed in the root window reference.
 	ei_rect_t*		content_rect;	///< Where to place children, when this widget is used as a container. By defaults, points to the screen_location.
+	ei_rect_t		content_rect_data;///< Storage of content_rect for the widget classes of the library.
+
+	/* Rendering */
+	struct ei_render_cache_t* render_cache;	///< Offscreen rendering of this widget and its descendants, NULL if the widget is not cached (see \ref ei_widget_set_cached).
+
+	/* Picking */
+	ei_rect_t		pick_rect;	///< Part of the widget stored in the spatial index used for picking, empty if the widget is not indexed.
+	int			pick_radius;	///< Radius of the rounded corners of pick_rect, 0 if they are straight.
 } ei_widget_t;
 
 
@@ -108,6 +120,52 @@ void			ei_widget_destroy		(ei_widget_t*		widget);
  */
 ei_widget_t*		ei_widget_pick			(ei_point_t*		where);
 
+/**
+ * @brief	The ways to find the widget at a given location, see \ref ei_widget_set_pick_mode.
+ */
+typedef enum {
+	ei_pick_offscreen	= 0,	///< Read the id of the widget in the picking offscreen, which must be drawn first.
+	ei_pick_geometry		///< Test the shapes of the widgets stored in a spatial index.
+} ei_pick_mode_t;
+
+/**
+ * @brief	Chooses how \ref ei_widget_pick finds the widget at a location. By default, the picking
+ *		offscreen is used. The geometry mode doesn't draw the picking offscreen, which is
+ *		faster when the widgets move often, but it only knows the shapes of the frames, the
+ *		buttons and the toplevels.
+ *
+ * @param	mode		The pick mode.
+ */
+void			ei_widget_set_pick_mode		(ei_pick_mode_t		mode);
+
+/**
+ * @brief	Enables or disables the offscreen cache of a widget. When enabled, the widget and its
+ *		descendants are rendered once in an offscreen surface, which is then copied on the
+ *		root window. They are rendered again only when one of them is configured, moved,
+ *		resized, created or destroyed. Useful for complex panels which rarely change.
+ *
+ * @param	widget		The widget.
+ * @param	cached		EI_TRUE to enable the cache, EI_FALSE to disable it and release its memory.
+ */
+void			ei_widget_set_cached		(ei_widget_t*		widget,
+							 ei_bool_t		cached);
+
+/**
+ * @brief	Puts a widget in front of its siblings: it becomes the last child of its parent, so it
+ *		is drawn over them and picked before them. Does nothing for the root widget.
+ *
+ * @param	widget		The widget to raise.
+ */
+void			ei_widget_raise			(ei_widget_t*		widget);
+
+/**
+ * @brief	Puts a widget behind its siblings: it becomes the first child of its parent, so they
+ *		are drawn over it. Does nothing for the root widget.
+ *
+ * @param	widget		The widget to lower.
+ */
+void			ei_widget_lower			(ei_widget_t*		widget);
+
 
 /**
  * @brief	Configures the attributes of widgets of the class "frame".
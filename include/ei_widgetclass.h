@@ -48,8 +48,9 @@ typedef void	(*ei_widgetclass_releasefunc_t)		(struct ei_widget_t*	widget);
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -108,6 +109,7 @@ typedef struct ei_widgetclass_t {
 	ei_widgetclass_setdefaultsfunc_t	setdefaultsfunc;	///< The function that sets the default values to all the parameters of an instance of this class of widget.
 	ei_widgetclass_geomnotifyfunc_t		geomnotifyfunc;		///< The function that is called to notify an instance of widget of this class that its geometry has changed.
 	ei_widgetclass_handlefunc_t		handlefunc;		///< The function that is called when the application has received a user event referring to an instance of this class of widget.
+	uint32_t				id;			///< A small integer given by \ref ei_widgetclass_register, used to test the class of a widget.
 	struct ei_widgetclass_t*		next;			///< A pointer to the next instance of ei_widget_class_t, allows widget class descriptions to be chained.
 } ei_widgetclass_t;
 
@@ -38,13 +38,6 @@ static ei_default_handle_func_t *g_default_handle_func = NULL;
  */
 static ei_bool_t is_rectangle_in_rectangle(ei_rect_t rectangle, ei_point_t t_point, ei_size_t* t_rect);
 
-/**
- * @param widget, the widget of which each child will be updated by @ref ei_placer_run function
- *
- * @return Nothing.
- */
-void children_resizing(struct ei_widget_t* widget);
-
 /**
  * @brief Replace all the parents that are toplevel of the widget to the front, i.e. the top parent
  * before the root frame is put as children tail (the last widget subtree printed).
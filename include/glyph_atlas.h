@@ -0,0 +1,42 @@
+#ifndef PROJETC_IG_GLYPH_ATLAS_H
+#define PROJETC_IG_GLYPH_ATLAS_H
+
+#include "ei_types.h"
+#include "hw_interface.h"
+
+/*
+ * Each font has an atlas of the glyphs already used: every glyph is rasterized once by
+ * hw_text_create_surface, its coverage is stored in the atlas, then texts are composed from it.
+ */
+
+/**
+ * @brief       Create a surface containing a text, composed from the glyphs of the atlas of the font.
+ *              The glyphs which are not yet in the atlas are rasterized and added to it.
+ *              Glyphs are placed one after the other using their advance and the kerning of each pair.
+ *              The surface has the size given by \ref text_cache_compute_size, which is used to place
+ *              the texts, so the composed text is never wider than the room made for it.
+ *
+ * @param       text        The string of the text, in UTF-8. Can't be NULL.
+ * @param       font        The font used to render the text. Can't be NULL.
+ * @param       color       The text color. The alpha parameter is not used, the alpha channel of the
+ *                          surface is the coverage of the glyphs (anti-aliasing).
+ *
+ * @return      The surface, just big enough to contain the text. The caller is responsible to release it
+ *              with \ref hw_surface_free.
+ */
+ei_surface_t glyph_atlas_create_text_surface(const char *text, ei_font_t font, ei_color_t color);
+
+/**
+ * @brief       Free the atlas of a font. It must be called before the font is freed, because a font created
+ *              later may have the same address.
+ *
+ * @param       font        The font, it may have no atlas.
+ */
+void glyph_atlas_forget(ei_font_t font);
+
+/**
+ * @brief       Free the atlases of all the fonts. It must be called before a font which has been used is freed.
+ */
+void glyph_atlas_release(void);
+
+#endif //PROJETC_IG_GLYPH_ATLAS_H
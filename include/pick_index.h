@@ -0,0 +1,51 @@
+#ifndef PROJETC_IG_PICK_INDEX_H
+#define PROJETC_IG_PICK_INDEX_H
+
+#include "ei_types.h"
+#include "ei_widget.h"
+
+// Size of the square cells of the spatial index, in pixels
+#define PICK_INDEX_CELL_SIZE 64
+
+/**
+ * @brief       Compute the part of a widget which can be picked, and store it in the spatial index.
+ *              It must be called each time the location, the size or the border of the widget changes.
+ *              The root widget and the widgets which are not managed by the placer are not indexed.
+ *
+ * @param       widget      The widget
+ */
+void pick_index_update(ei_widget_t *widget);
+
+/**
+ * @brief       Move the indexed part of a widget whose location has been translated, without computing
+ *              its shape again. It does nothing if the widget is not indexed.
+ *
+ * @param       widget      The widget
+ * @param       shift       The translation
+ */
+void pick_index_translate(ei_widget_t *widget, ei_point_t shift);
+
+/**
+ * @brief       Remove a widget from the spatial index. It does nothing if the widget is not indexed.
+ *
+ * @param       widget      The widget
+ */
+void pick_index_remove(ei_widget_t *widget);
+
+/**
+ * @brief       Return the top-most indexed widget at a location, without using the picking offscreen.
+ *              Rounded corners of buttons are tested exactly, and widgets are clipped by the content
+ *              rect of their ancestors as when they are drawn.
+ *
+ * @param       where       The location, expressed in the root window coordinates.
+ *
+ * @return      The widget, or NULL if only the root widget is at this location.
+ */
+ei_widget_t *pick_index_find(ei_point_t where);
+
+/**
+ * @brief       Free the memory used by the spatial index.
+ */
+void pick_index_release(void);
+
+#endif //PROJETC_IG_PICK_INDEX_H
@@ -0,0 +1,33 @@
+#ifndef PROJETC_IG_PIXEL_KERNELS_H
+#define PROJETC_IG_PIXEL_KERNELS_H
+
+#include <stdint.h>
+
+/*
+ * Kernels which write runs of 32 bits pixels. The best implementation available on the CPU
+ * (AVX2, SSE2 or scalar) is selected once, the first time a kernel is called.
+ */
+
+/**
+ * @brief       Write the same 32 bits color on consecutive pixels.
+ *
+ * @param       dst         The first pixel to write
+ * @param       color       The color, already mapped with ei_map_rgba
+ * @param       count       The number of pixels to write. Nothing is done if it is not positive.
+ */
+void fill_span(uint32_t *dst, uint32_t color, int32_t count);
+
+/**
+ * @brief       Blend consecutive source pixels on destination pixels, weighted by the alpha channel of the source.
+ *              Each color channel is rounded: (src * alpha + dst * (255 - alpha) + 127) / 255, and the alpha
+ *              channel of the destination becomes 255. Fully transparent source pixels don't change the color
+ *              channels, and a fully transparent destination pixel under them is left unchanged.
+ *
+ * @param       dst         The first destination pixel
+ * @param       src         The first source pixel, the channels must be in the same order than in dst
+ * @param       count       The number of pixels to blend. Nothing is done if it is not positive.
+ * @param       alpha_place The index of the alpha channel in a pixel, as given by hw_surface_get_channel_indices
+ */
+void blend_span(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place);
+
+#endif //PROJETC_IG_PIXEL_KERNELS_H
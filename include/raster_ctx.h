@@ -0,0 +1,68 @@
+#ifndef PROJETC_IG_RASTER_CTX_H
+#define PROJETC_IG_RASTER_CTX_H
+
+#include <stdint.h>
+#include "single_linked_list.h"
+#include "ei_types.h"
+
+/**
+ * @brief       Memory used by the polygon rasterizer. It is kept between two calls, so that filling a polygon
+ *              doesn't need any allocation once the biggest polygon has been drawn.
+ */
+typedef struct ei_raster_ctx {
+        side*           pool;           ///< Storage of the sides of the current polygon
+        uint32_t        pool_size;      ///< Number of sides which can be stored in pool
+        uint32_t        nb_sides;       ///< Number of sides of pool used by the current polygon
+
+        side**          tc;             ///< Edge table, one bucket per scanline of the current polygon
+        uint32_t        tc_size;        ///< Number of buckets which can be stored in tc
+
+        ei_point_t*     points;         ///< Points of a linked list given to the drawing functions
+        uint32_t        points_size;    ///< Number of points which can be stored in points
+} ei_raster_ctx;
+
+/**
+ * @brief       Return the rasterizer context shared by all drawing functions.
+ *
+ * @return      The context. It must not be freed by the user, see \ref raster_ctx_release.
+ */
+ei_raster_ctx *raster_ctx_get(void);
+
+/**
+ * @brief       Prepare the context for a new polygon: the sides of the previous one are discarded,
+ *              the pool and the edge table grow if they are too small.
+ *
+ * @param       ctx         The context
+ * @param       nb_sides    The maximum number of sides of the polygon
+ * @param       nb_lines    The number of scanlines of the polygon. All the buckets are emptied.
+ */
+void raster_ctx_reset(ei_raster_ctx *ctx, uint32_t nb_sides, uint32_t nb_lines);
+
+/**
+ * @brief       Return an unused side of the pool. \ref raster_ctx_reset must have reserved enough sides.
+ *
+ * @param       ctx         The context
+ *
+ * @return      The side, its fields are not initialized.
+ */
+static inline side *raster_ctx_new_side(ei_raster_ctx *ctx) {
+        return &ctx->pool[ctx->nb_sides++];
+}
+
+/**
+ * @brief       Return the point buffer of the context, it grows if it is too small.
+ *              Its content is not kept when it grows.
+ *
+ * @param       ctx         The context
+ * @param       nb_points   The number of points which must be stored.
+ *
+ * @return      The buffer, owned by the context.
+ */
+ei_point_t *raster_ctx_points(ei_raster_ctx *ctx, uint32_t nb_points);
+
+/**
+ * @brief       Free the memory used by the shared context.
+ */
+void raster_ctx_release(void);
+
+#endif //PROJETC_IG_RASTER_CTX_H
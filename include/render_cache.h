@@ -0,0 +1,62 @@
+#ifndef PROJETC_IG_RENDER_CACHE_H
+#define PROJETC_IG_RENDER_CACHE_H
+
+#include "ei_types.h"
+#include "ei_widget.h"
+#include "hw_interface.h"
+
+/**
+ * @brief       Offscreen rendering of a widget and its descendants. It is copied on the root window
+ *              instead of drawing the subtree again, as long as nothing changes in the subtree.
+ */
+typedef struct ei_render_cache_t {
+        ei_surface_t    surface;        ///< The rendering, NULL until the subtree is drawn for the first time
+        ei_bool_t       is_valid;       ///< EI_FALSE when the subtree has changed since it was rendered
+} ei_render_cache_t;
+
+/**
+ * @brief       Allocate an empty cache, which must be rendered before being copied.
+ *
+ * @return      The cache, it must be freed by \ref render_cache_free.
+ */
+ei_render_cache_t *render_cache_create(void);
+
+/**
+ * @brief       Free a cache and its surface.
+ *
+ * @param       cache       The cache, it can be NULL.
+ */
+void render_cache_free(ei_render_cache_t *cache);
+
+/**
+ * @brief       Mark as outdated the caches of a widget and of all its ancestors, which all contain
+ *              the rendering of the widget.
+ *
+ * @param       widget      The widget which has changed, it can be NULL.
+ */
+void render_cache_invalidate(ei_widget_t *widget);
+
+/**
+ * @brief       Prepare the cache of a widget to render its subtree again: the surface gets the size of
+ *              the widget and is cleared to a value which marks the untouched pixels. Its origin is the
+ *              top-left corner of the widget, so the subtree is drawn with the coordinates of the root window.
+ *              The cache is valid once this function returns.
+ *
+ * @param       widget      The widget, its render_cache field must not be NULL.
+ *
+ * @return      The surface where the subtree must be drawn.
+ */
+ei_surface_t render_cache_begin(ei_widget_t *widget);
+
+/**
+ * @brief       Copy the rendering of a widget on a surface, only the part inside the clipper.
+ *              The pixels drawn by the subtree replace the ones of the surface, exactly as if the subtree
+ *              was drawn on it. The pixels it has not drawn let the surface unchanged.
+ *
+ * @param       widget      The widget, its cache must have been rendered.
+ * @param       surface     Where to copy the rendering, in the root window coordinates.
+ * @param       clipper     The visible part of the widget.
+ */
+void render_cache_copy(ei_widget_t *widget, ei_surface_t surface, const ei_rect_t *clipper);
+
+#endif //PROJETC_IG_RENDER_CACHE_H
@@ -8,20 +8,21 @@
  * @brief       Side structure used to represent all caracteristic of a side in a polygon. It is a single linked list.
  **/
 typedef struct side{
-        uint32_t ymax;
-        uint32_t xymin;
-        double_t inv_slope;
+        int32_t ymax;           ///< Scanline where the side ends (excluded)
+        int32_t xymin;          ///< Intersection of the side with the current scanline
+        int32_t x_step;         ///< Integer part of the inverse slope (dx / dy, rounded down)
+        int32_t error_step;     ///< Remaining part of the inverse slope, multiplied by dy
 
-        int32_t error;          ///< Error used for Bresenham Algorithm
+        int32_t error;          ///< Error used for Bresenham Algorithm, always in [0, dy)
         int32_t dx, dy;
 
         struct side* next;
 } side;
 
 /*
- * Insertion of new_side on tail of single linked list ll
+ * Insertion of new_side in the linked list ll sorted by abscisse
 */
-extern void insert(struct side **ll, struct side *new_side);
+extern void insert_sorted(struct side **ll, struct side *new_side);
 
 /*
  * Deletion of each side where ymax == ymax
@@ -29,27 +30,12 @@ extern void insert(struct side **ll, struct side *new_side);
 extern void delete(struct side **ll, int ymax);
 
 /*
- * Move each component of linked list ll1 on tail of linked list ll2
+ * Merge the sorted linked list ll1 into the sorted linked list ll2
  */
-extern void move(struct side **ll1, struct side **ll2);
+extern void merge(struct side **ll1, struct side **ll2);
 
 /*
- * Test if the tab tc is empty
- */
-extern int is_empty (struct side **tc, uint32_t size_tab);
-
-/*
- * Sort linked list by abscisse with an insertion sort
- */
-extern void insertion_sort(struct side **tc);
-
-/*
- * Return xymin elem of the node placed in the position index of linked list
- */
-extern int32_t get_xymin(struct side *tc, uint32_t index);
-
-/*
- * Update xymin (intersection point) of linked list with Bresenham algorithm
+ * Update xymin (intersection point) of linked list with Bresenham algorithm, keeping it sorted by abscisse
  */
 extern void set_xymin(struct side **ll);
 
@@ -0,0 +1,90 @@
+#ifndef PROJETC_IG_TEXT_CACHE_H
+#define PROJETC_IG_TEXT_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ei_types.h"
+#include "hw_interface.h"
+
+// Default memory budget of the cached surfaces, in bytes
+#define TEXT_CACHE_DEFAULT_BUDGET (4 * 1024 * 1024)
+
+// Maximum number of cached text sizes, they are all forgotten when it is reached
+#define TEXT_CACHE_MAX_SIZES 4096
+
+/**
+ * @brief       Statistics of the text surface cache.
+ */
+typedef struct text_cache_stats_t {
+        uint64_t        hits;           ///< Number of requests answered with a cached surface
+        uint64_t        misses;         ///< Number of requests which rendered a new surface
+        uint64_t        evictions;      ///< Number of surfaces freed to respect the budget
+        uint32_t        entries;        ///< Number of surfaces currently cached
+        size_t          bytes;          ///< Memory used by the cached surfaces, in bytes
+
+        uint64_t        size_hits;      ///< Number of text sizes answered from the cache
+        uint64_t        size_misses;    ///< Number of text sizes computed by the font engine
+} text_cache_stats_t;
+
+/**
+ * @brief       Return the surface of a text rendered with a font and a color. The surface is composed
+ *              from the glyph atlas of the font only if it is not already in the cache.
+ *              The least recently used surfaces are freed when the budget is exceeded.
+ *
+ * @param       text        The string of the text. Can't be NULL.
+ * @param       font        The font used to render the text. Can't be NULL.
+ * @param       color       The text color.
+ *
+ * @return      The surface, owned by the cache. It stays valid until the next call to this function.
+ */
+ei_surface_t text_cache_get(const char *text, ei_font_t font, ei_color_t color);
+
+/**
+ * @brief       Computes the size of a text surface given the font and the text. The size is computed
+ *              by \ref hw_text_compute_size only if it is not already in the cache.
+ *
+ * @param       text            The string of the text. Can't be NULL.
+ * @param       font            The font used to render the text. Can't be NULL.
+ * @param       width, height   Addresses where to store the computed width and height of the text surface.
+ */
+void text_cache_compute_size(const char *text, ei_font_t font, int *width, int *height);
+
+/**
+ * @brief       Forget the size of a text, when a widget doesn't display it anymore.
+ *
+ * @param       text            The string of the text. Can't be NULL.
+ * @param       font            The font used to render the text.
+ */
+void text_cache_forget_size(const char *text, ei_font_t font);
+
+/**
+ * @brief       Free the surfaces rendered with a font and the sizes measured with it. It must be called
+ *              before the font is freed, because a font created later may have the same address.
+ *              The statistics are kept.
+ *
+ * @param       font        The font
+ */
+void text_cache_forget_font(ei_font_t font);
+
+/**
+ * @brief       Change the memory budget of the cached surfaces. Surfaces are freed if it is exceeded.
+ *
+ * @param       budget      The budget, in bytes. 0 disables the cache.
+ */
+void text_cache_set_budget(size_t budget);
+
+/**
+ * @brief       Return the statistics of the cache since the beginning of the program.
+ *
+ * @return      The statistics.
+ */
+text_cache_stats_t text_cache_get_stats(void);
+
+/**
+ * @brief       Free every cached surface and size, for example before freeing a font which has been used.
+ *              The statistics are kept.
+ */
+void text_cache_flush(void);
+
+#endif //PROJETC_IG_TEXT_CACHE_H
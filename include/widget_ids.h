@@ -0,0 +1,47 @@
+#ifndef PROJETC_IG_WIDGET_IDS_H
+#define PROJETC_IG_WIDGET_IDS_H
+
+#include <stdint.h>
+
+#include "ei_widget.h"
+
+// Initial number of slots of the table of widgets indexed by pick_id
+#define WIDGET_IDS_INITIAL_SIZE 256
+
+/**
+ * @brief       Return an id for a new widget. The ids of the destroyed widgets are used first, so the
+ *              ids stay dense and the pick colors stay small. The id 0 is kept for the root widget.
+ *
+ * @return      The id.
+ */
+uint32_t widget_ids_new(void);
+
+/**
+ * @brief       Store a widget in the table at the index given by its pick_id. The table grows if needed.
+ *
+ * @param       widget      The widget
+ */
+void widget_ids_register(ei_widget_t *widget);
+
+/**
+ * @brief       Remove a widget from the table, its id is given again by \ref widget_ids_new.
+ *
+ * @param       widget      The widget
+ */
+void widget_ids_forget(ei_widget_t *widget);
+
+/**
+ * @brief       Return the widget which has an id.
+ *
+ * @param       pick_id     The id, read in the picking offscreen for example
+ *
+ * @return      The widget, or NULL if no widget has this id.
+ */
+ei_widget_t *widget_ids_find(uint32_t pick_id);
+
+/**
+ * @brief       Free the memory used by the table and the free ids. The next id is 1 again.
+ */
+void widget_ids_release(void);
+
+#endif //PROJETC_IG_WIDGET_IDS_H
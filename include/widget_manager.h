@@ -53,6 +53,7 @@ typedef struct ei_button_t {
         ei_anchor_t		text_anchor;
         ei_surface_t		img;
         ei_rect_t*		img_rect;
+        ei_rect_t		img_rect_data;
         ei_anchor_t		img_anchor;
         ei_callback_t		callback;
         void*			user_param;
@@ -70,6 +71,12 @@ typedef struct ei_top_level_t {
         ei_rect_t*              resize_rect;
         ei_rect_t*              top_bar;
         current_event           current_event;
+
+        // Storage of the pointed attributes, so that a toplevel is allocated in one block
+        ei_size_t               min_size_data;
+        ei_button_t             close_button_data;
+        ei_rect_t               resize_rect_data;
+        ei_rect_t               top_bar_data;
 } ei_top_level_t;
 
 typedef struct ei_frame_t {
@@ -83,6 +90,7 @@ typedef struct ei_frame_t {
         ei_anchor_t		text_anchor;
         ei_surface_t		img;
         ei_rect_t*		img_rect;
+        ei_rect_t		img_rect_data;
         ei_anchor_t		img_anchor;
 } ei_frame_t;
 
@@ -108,6 +116,11 @@ ei_widget_t* top_level_alloc_func();
  */
 ei_widget_t* frame_alloc_func();
 
+/**
+ * @brief       Free the pools of memory used by the widgets of the library. All the widgets must be destroyed.
+ */
+void widget_pools_release(void);
+
 /*
  * Release functions
  */
@@ -142,8 +155,9 @@ void frame_release(ei_widget_t* widget);
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -157,8 +171,9 @@ void ei_draw_button (ei_widget_t* widget,
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -172,8 +187,9 @@ void ei_draw_frame (ei_widget_t* widget,
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -259,7 +275,7 @@ void top_level_geomnotifyfunc (struct ei_widget_t* widget, ei_rect_t rect);
  *
  * @return      A point which represents coordinates of top-left text place
  */
-ei_point_t* text_place(ei_anchor_t *text_anchor, ei_size_t *text_size, ei_point_t *widget_place, ei_size_t *widget_size);
+ei_point_t text_place(ei_anchor_t *text_anchor, ei_size_t *text_size, ei_point_t *widget_place, ei_size_t *widget_size);
 
 /**
  * @brief       All is in the title
@@ -267,9 +283,9 @@ ei_point_t* text_place(ei_anchor_t *text_anchor, ei_size_t *text_size, ei_point_
  * @param       surface             Used to know rgba position in the corresponding surface
  * @param       color_to_convert    Element which is convert into ei_color_t
  *
- * @return      A color corresponding to the 32 bits give as argument. This color must be free by user.
+ * @return      A color corresponding to the 32 bits give as argument.
  */
-ei_color_t *inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert);
+ei_color_t inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert);
 
 /**
  * @brief       Update child field of parent. It is a course of linked list.
@@ -279,6 +295,14 @@ ei_color_t *inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert);
  */
 static void insert_child(ei_widget_t *widget, ei_widget_t *parent);
 
+/**
+ * @brief       Remove a widget from the children of its parent, in constant time thanks to the
+ *              doubly linked siblings. The parent field of the widget is kept.
+ *
+ * @param       widget      The widget child
+ */
+void unlink_child(ei_widget_t *widget);
+
 
 /**
  * @brief       This function return the higher id used into tree which represents all the widgets.
@@ -288,14 +312,4 @@ static void insert_child(ei_widget_t *widget, ei_widget_t *parent);
  */
 static uint32_t last_id(void);
 
-/**
- * @brief       Return widget class wich correspond to class name give in parameter.
- *
- * @param       ll              The linked list which contained all classes (button, top-level and frame).
- * @param       class_name      The class name.
- *
- * @return      The class corresponding of class_name if exists. If not, return NULL.
- */
-ei_widgetclass_t *get_class(ei_widgetclass_t *ll, ei_widgetclass_name_t class_name);
-
 #endif //PROJETC_IG_WIDGET_MANAGER_H
@@ -0,0 +1,52 @@
+#ifndef PROJETC_IG_WIDGET_POOL_H
+#define PROJETC_IG_WIDGET_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Blocks are aligned on cache lines, so that a widget never shares a line with another one
+#define WIDGET_POOL_CACHE_LINE 64
+
+// Size of the memory allocated at once by a pool, in bytes
+#define WIDGET_POOL_SLAB_SIZE (64 * 1024)
+
+/**
+ * @brief       Allocator of fixed size blocks, taken in big slabs. The free blocks are chained in a list,
+ *              so allocating or freeing a block is done in constant time without calling malloc.
+ */
+typedef struct widget_pool {
+        size_t          block_size;     ///< Size of a block, a multiple of the cache line
+        void*           free_blocks;    ///< First free block, each free block begins with a pointer on the next one
+        void**          slabs;          ///< Memory allocated by the pool
+        uint32_t        nb_slabs;       ///< Number of slabs
+        uint32_t        slabs_size;     ///< Number of slabs which can be stored in slabs
+} widget_pool;
+
+// Initializer of a pool of blocks which can contain a type
+#define WIDGET_POOL_INIT(type) {((sizeof(type) + WIDGET_POOL_CACHE_LINE - 1) / WIDGET_POOL_CACHE_LINE) * WIDGET_POOL_CACHE_LINE, NULL, NULL, 0, 0}
+
+/**
+ * @brief       Return a block of the pool, filled with zeros. A new slab is allocated if there is no free block.
+ *
+ * @param       pool        The pool
+ *
+ * @return      The block, aligned on a cache line.
+ */
+void *widget_pool_alloc(widget_pool *pool);
+
+/**
+ * @brief       Give a block back to the pool, it is used by the next allocation.
+ *
+ * @param       pool        The pool which gave the block
+ * @param       block       The block
+ */
+void widget_pool_free(widget_pool *pool, void *block);
+
+/**
+ * @brief       Free all the slabs of the pool. The blocks which were not given back become invalid.
+ *
+ * @param       pool        The pool
+ */
+void widget_pool_release(widget_pool *pool);
+
+#endif //PROJETC_IG_WIDGET_POOL_H
@@ -0,0 +1,110 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "class_registry.h"
+
+// Hash table with open addressing, NULL for empty slots. It is at most half full.
+static ei_widgetclass_t **g_classes = NULL;
+static uint32_t g_size = 0;
+static uint32_t g_nb_classes = 0;
+
+// Id of the next registered class
+static uint32_t g_next_id = 1;
+
+/**
+ * @brief       Compute the FNV-1a hash of a class name.
+ *
+ * @param       name        The name of the class
+ *
+ * @return      The hash.
+ */
+static uint32_t hash_name(const char *name) {
+        uint32_t hash = 2166136261u;
+        for (const char *c = name ; *c != '\0' && c < name + sizeof(ei_widgetclass_name_t) ; ++c) {
+                hash = (hash ^ (uint8_t) *c) * 16777619u;
+        }
+        return hash;
+}
+
+/**
+ * @brief       Return the slot of a name in the hash table: the slot of the class which has this name,
+ *              or the empty slot where it must be inserted.
+ *
+ * @param       name        The name of the class
+ *
+ * @return      The slot.
+ */
+static ei_widgetclass_t **find_slot(const char *name) {
+        uint32_t index = hash_name(name) & (g_size - 1);
+        while (g_classes[index] != NULL
+               && strncmp(g_classes[index]->name, name, sizeof(ei_widgetclass_name_t)) != 0) {
+                index = (index + 1) & (g_size - 1);
+        }
+        return &g_classes[index];
+}
+
+/**
+ * @brief       Double the size of the hash table, or create it, and insert again its classes.
+ */
+static void grow(void) {
+        ei_widgetclass_t **old_classes = g_classes;
+        uint32_t old_size = g_size;
+
+        g_size = g_size ? 2 * g_size : CLASS_REGISTRY_INITIAL_SIZE;
+        g_classes = calloc(g_size, sizeof(ei_widgetclass_t*));
+        for (uint32_t i = 0 ; i < old_size ; ++i) {
+                if (old_classes[i]) {
+                        *find_slot(old_classes[i]->name) = old_classes[i];
+                }
+        }
+        free(old_classes);
+}
+
+/**
+ * @brief       Store a class in the hash table indexed by its name, and give it an id. The ids are given
+ *              in the registration order, starting at 1. If a class of the same name was registered
+ *              before, it is replaced and its id is kept.
+ *
+ * @param       widgetclass     The class
+ *
+ * @return      The id of the class.
+ */
+uint32_t class_registry_add(ei_widgetclass_t *widgetclass) {
+        if (2 * (g_nb_classes + 1) > g_size) {
+                grow();
+        }
+
+        ei_widgetclass_t **slot = find_slot(widgetclass->name);
+        if (*slot) {
+                widgetclass->id = (*slot)->id;
+        } else {
+                widgetclass->id = g_next_id++;
+                ++g_nb_classes;
+        }
+        *slot = widgetclass;
+        return widgetclass->id;
+}
+
+/**
+ * @brief       Return the class which has a name.
+ *
+ * @param       name        The name of the class
+ *
+ * @return      The class, or NULL if no class has this name.
+ */
+ei_widgetclass_t *class_registry_find(const char *name) {
+        if (g_classes == NULL) return NULL;
+        return *find_slot(name);
+}
+
+/**
+ * @brief       Free the memory used by the hash table. The classes themselves are not freed, and the
+ *              next id is 1 again.
+ */
+void class_registry_release(void) {
+        free(g_classes);
+        g_classes = NULL;
+        g_size = 0;
+        g_nb_classes = 0;
+        g_next_id = 1;
+}
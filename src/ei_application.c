@@ -5,6 +5,118 @@
 #include "ei_widget.h"
 #include "widget_manager.h"
 #include "event_manager.h"
+#include "raster_ctx.h"
+#include "ei_create_button.h"
+#include "text_cache.h"
+#include "glyph_atlas.h"
+#include "render_cache.h"
+#include "pick_index.h"
+#include "widget_ids.h"
+#include "class_registry.h"
+
+// Rectangles of the root window which must be redrawn on the next frame. They never overlap.
+static ei_linked_rect_t *g_invalidated_rects = NULL;
+
+// Rectangles of the root window whose pixels have been copied from another place, they are updated on screen on
+// the next frame without being drawn again
+static ei_linked_rect_t *g_copied_rects = NULL;
+
+// Rectangles of the picking offscreen which must be redrawn before the next pick. They never overlap.
+static ei_linked_rect_t *g_pick_invalidated_rects = NULL;
+
+// Version of the geometry of the widgets, and the version drawn in the picking offscreen
+static uint32_t g_geometry_version = 0;
+static uint32_t g_pick_version = 0;
+
+// Marker posted in the event queue after a mouse move: the events received before it were already waiting.
+// A run stopped by another event leaves its marker in the queue, so several markers may be waiting.
+static int g_coalescing_marker;
+static uint32_t g_nb_posted_markers = 0;
+
+// Event which stopped a run of mouse moves, it is treated after the last mouse move of the run
+static ei_event_t g_held_event;
+static ei_bool_t g_has_held_event = EI_FALSE;
+
+// Number of mouse moves which have been replaced by a more recent one
+static uint32_t g_nb_coalesced_events = 0;
+
+// A frame must be drawn, because a region has been invalidated or a redraw has been requested
+static ei_bool_t g_needs_redraw = EI_FALSE;
+
+// Minimum time between two frames and time of the last frame, in seconds
+static double g_frame_interval = EI_DEFAULT_FRAME_INTERVAL;
+static double g_last_frame_time = 0;
+static ei_bool_t g_has_drawn_frame = EI_FALSE;
+
+// Event scheduled to wake the main loop when a frame is delayed
+static int g_frame_marker;
+static ei_bool_t g_is_frame_scheduled = EI_FALSE;
+
+/**
+ * @brief       Free every rectangle of a linked list of rectangles.
+ *
+ * @param       rects       The linked list to free
+ */
+static void free_rects(ei_linked_rect_t *rects) {
+        while (rects) {
+                ei_linked_rect_t *to_suppr = rects;
+                rects = rects->next;
+                free(to_suppr);
+        }
+}
+
+static void draw_widgets(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t clipper);
+static void add_rect(ei_linked_rect_t **rects, ei_rect_t rect);
+
+/**
+ * @brief       Draw a widget, then its children on top of it.
+ *
+ * @param       widget          The root of the subtree to draw
+ * @param       surface         Where to draw the subtree. If NULL, only the picking offscreen is drawn.
+ * @param       pick_surface    The picking offscreen. If NULL, it is not drawn.
+ * @param       clipper         The visible part of the widget, expressed in the root window coordinates
+ */
+static void draw_subtree(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t clipper) {
+        widget->wclass->drawfunc(widget, surface, pick_surface, &clipper);
+
+        // Children are clipped by the content rect of their parent
+        ei_rect_t children_clipper = ei_rect_intersection(*widget->content_rect, clipper);
+        if (ei_rect_is_empty(children_clipper)) return;
+
+        // The last children is printed at the end (i.e. the front).
+        // The first children is printed at the background (but in front of its parent).
+        for (ei_widget_t *child = widget->children_head ; child != NULL ; child = child->next_sibling) {
+                if (child->placer_params) draw_widgets(child, surface, pick_surface, children_clipper);
+        }
+}
+
+/**
+ * @brief       Draw a widget and its subtree. Only the part of each widget which is inside the clipper is drawn.
+ *              A subtree which doesn't intersect the clipper is skipped. A cached subtree is copied from
+ *              its cache, which is rendered again only if it is outdated.
+ *
+ * @param       widget          The root of the subtree to draw
+ * @param       surface         Where to draw the subtree. If NULL, only the picking offscreen is drawn.
+ * @param       pick_surface    The picking offscreen. If NULL, it is not drawn.
+ * @param       clipper         The visible part of the widget, expressed in the root window coordinates
+ */
+static void draw_widgets(ei_widget_t *widget, ei_surface_t surface, ei_surface_t pick_surface, ei_rect_t clipper) {
+        if (ei_rect_is_empty(ei_rect_intersection(widget->screen_location, clipper))) return;
+
+        if (widget->render_cache && surface) {
+                // The whole widget is rendered in its cache, whatever the clipper is
+                if (!widget->render_cache->is_valid) {
+                        draw_subtree(widget, render_cache_begin(widget), NULL, widget->screen_location);
+                }
+                render_cache_copy(widget, surface, &clipper);
+
+                // The picking offscreen is not cached, only the picking colors of the subtree are drawn
+                if (pick_surface) draw_subtree(widget, NULL, pick_surface, clipper);
+                return;
+        }
+
+        draw_subtree(widget, surface, pick_surface, clipper);
+}
 
 /**
  * @brief	Registers a class to the program so that widgets of this class can be created.
@@ -40,6 +152,9 @@ void ei_widgetclass_register(ei_widgetclass_t* widgetclass) {
                 frame_class->geomnotifyfunc = &frame_geomnotifyfunc;
                 frame_class->handlefunc = &handle_frame_function;
         }
+
+        // The class is found by its name in a hash table, and its instances are told apart by its id
+        class_registry_add(widgetclass);
 }
 
 /**
@@ -50,14 +165,7 @@ void ei_widgetclass_register(ei_widgetclass_t* widgetclass) {
  * @return			The structure describing the class.
  */
 ei_widgetclass_t*	ei_widgetclass_from_name	(ei_widgetclass_name_t name) {
-        ei_widgetclass_t *current_class = frame_class;
-        while (current_class) {
-              if (current_class->name == name) {
-                      return current_class;
-              }
-              current_class = current_class->next;
-        }
-        return NULL;
+        return class_registry_find(ei_widgetclass_stringname(name));
 }
 
 /**
@@ -115,9 +223,123 @@ void ei_app_create(ei_size_t main_window_size, ei_bool_t fullscreen){
         g_root_frame->content_rect->top_left = g_root_frame->screen_location.top_left;
         g_root_frame->content_rect->size = g_root_frame->screen_location.size;
 
-        // Event management
-        g_root_frame->pick_id = 0;
-        g_root_frame->pick_color = inverse_map_rgba(g_offscreen, g_root_frame->pick_id);
+        // No mouse move has been coalesced yet
+        g_nb_coalesced_events = 0;
+        g_nb_posted_markers = 0;
+        g_has_held_event = EI_FALSE;
+
+        // The first frame is drawn without waiting
+        g_has_drawn_frame = EI_FALSE;
+        g_is_frame_scheduled = EI_FALSE;
+
+        // The whole window and the whole picking offscreen must be drawn on the first frame
+        ei_app_invalidate_rect(&g_root_frame->screen_location);
+        invalidate_geometry_rect(&g_root_frame->screen_location);
+}
+
+/**
+ * @brief       Test if an event is the marker posted to coalesce the mouse moves.
+ *
+ * @param       event       The event
+ *
+ * @return      EI_TRUE if it is the marker.
+ */
+static ei_bool_t is_coalescing_marker(ei_event_t *event) {
+        return event->type == ei_ev_app && event->param.application.user_param == &g_coalescing_marker;
+}
+
+/**
+ * @brief       Wait for the next event to treat. When a mouse move is received, the mouse moves which are
+ *              already waiting in the queue are read too, and only the last one is returned. The run stops at
+ *              the first other event (a button pressed or released, for example) which is returned next time.
+ *
+ * @param       event       Where to write the event
+ */
+static void wait_next_event(ei_event_t *event) {
+        if (g_has_held_event) {
+                *event = g_held_event;
+                g_has_held_event = EI_FALSE;
+                return;
+        }
+
+        // The marker of a previous run may arrive after the event which stopped it
+        do {
+                hw_event_wait_next(event);
+                if (is_coalescing_marker(event)) --g_nb_posted_markers;
+        } while (is_coalescing_marker(event));
+
+        if (event->type != ei_ev_mouse_move) return;
+
+        // Every event before the marker was already waiting, the events which come later are not waited for.
+        // If the marker can't be posted, the end of the run would not be known: the move is treated alone.
+        if (hw_event_post_app(&g_coalescing_marker) <= 0) return;
+        ++g_nb_posted_markers;
+
+        ei_event_t following;
+        while (EI_TRUE) {
+                hw_event_wait_next(&following);
+
+                // The markers of the previous runs arrive before the marker of this run
+                if (is_coalescing_marker(&following)) {
+                        if (--g_nb_posted_markers == 0) return;
+                        continue;
+                }
+                if (following.type != ei_ev_mouse_move || following.param.mouse.modifier_mask != event->param.mouse.modifier_mask) {
+                        g_held_event = following;
+                        g_has_held_event = EI_TRUE;
+                        return;
+                }
+
+                // Only the latest position is kept
+                *event = following;
+                ++g_nb_coalesced_events;
+        }
+}
+
+/**
+ * @brief       Draw the damaged regions of the window, or the whole window if there is none, then update
+ *              them on screen. The picking offscreen is updated separately, only when the geometry has changed.
+ */
+static void draw_frame(void) {
+        if (g_invalidated_rects == NULL && g_copied_rects == NULL) {
+                add_rect(&g_invalidated_rects, g_root_frame->screen_location);
+        }
+
+        for (ei_linked_rect_t *damage = g_invalidated_rects ; damage != NULL ; damage = damage->next) {
+                draw_widgets(g_root_frame, g_root_windows, NULL, damage->rect);
+        }
+
+        // The copied pixels are updated on screen with the drawn ones, the lists are chained for the update
+        ei_linked_rect_t **tail = &g_invalidated_rects;
+        while (*tail) tail = &(*tail)->next;
+        *tail = g_copied_rects;
+        hw_surface_update_rects(g_root_windows, g_invalidated_rects);
+
+        free_rects(g_invalidated_rects);
+        g_invalidated_rects = NULL;
+        g_copied_rects = NULL;
+        g_needs_redraw = EI_FALSE;
+}
+
+/**
+ * @brief       Draw a frame if it is needed and if the last one is old enough. Otherwise, the main loop is
+ *              woken up by a scheduled event when the frame interval is over.
+ */
+static void pace_frame(void) {
+        if (!g_needs_redraw) return;
+
+        double now = hw_now();
+        double elapsed = now - g_last_frame_time;
+        if (!g_has_drawn_frame || elapsed >= g_frame_interval) {
+                draw_frame();
+                g_last_frame_time = now;
+                g_has_drawn_frame = EI_TRUE;
+        } else if (!g_is_frame_scheduled) {
+                // Rounded up, so that the interval is over when the event is received
+                int ms_delay = (int) ((g_frame_interval - elapsed) * 1000) + 1;
+                hw_event_schedule_app(ms_delay, &g_frame_marker);
+                g_is_frame_scheduled = EI_TRUE;
+        }
 }
 
 /**
@@ -131,35 +353,22 @@ void ei_app_run(void){
 
         while (g_not_the_end) {
 
-                // Draw the root frame
-                g_root_frame->wclass->drawfunc(g_root_frame, g_root_windows, g_offscreen, NULL);
-
-                // Depth course of each widgets in order to print them.
-                // The last children is printed at the end (i.e. the front).
-                // The first children is printed at the background (but in front of the root frame).
-                ei_widget_t *widget_to_print = g_root_frame;
-                do {
-                        ei_widget_t* parent;
-                        if (widget_to_print->children_head) {
-                                parent = widget_to_print;
-                                widget_to_print = widget_to_print->children_head;
-                                widget_to_print->wclass->drawfunc(widget_to_print, g_root_windows, g_offscreen, parent->content_rect);
-                        } else {
-                                while (widget_to_print != g_root_frame && widget_to_print->next_sibling == NULL) {
-                                        widget_to_print = widget_to_print->parent;
-                                }
-
-                                if (widget_to_print->next_sibling) {
-                                        parent = widget_to_print->parent;
-                                        widget_to_print = widget_to_print->next_sibling;
-                                        widget_to_print->wclass->drawfunc(widget_to_print, g_root_windows, g_offscreen, parent->content_rect);
-                                }
-                        }
-                } while (widget_to_print != g_root_frame);
+                // Redraw only the damaged regions of the window, at most once per frame interval
+                pace_frame();
 
-                // Update screen and event
-                hw_surface_update_rects(g_root_windows, NULL);
-                hw_event_wait_next(g_next_event);
+                // Wait for the next event, runs of mouse moves are treated once
+                wait_next_event(g_next_event);
+
+                // The frame interval is over, the delayed frame is drawn
+                if (g_next_event->type == ei_ev_app && g_next_event->param.application.user_param == &g_frame_marker) {
+                        g_is_frame_scheduled = EI_FALSE;
+                        continue;
+                }
+
+                // The window has been exposed, everything must be redrawn
+                if (g_next_event->type == ei_ev_exposed) {
+                        ei_app_invalidate_rect(&g_root_frame->screen_location);
+                }
 
                 // Used to know if the event has been treated or not
                 ei_bool_t has_been_treated = EI_FALSE;
@@ -195,6 +404,26 @@ void ei_app_free(void){
 
         // Delete all existing widgets
         ei_widget_destroy(g_root_frame);
+        pick_index_release();
+        widget_ids_release();
+        widget_pools_release();
+        layout_release();
+
+        // Delete damaged regions which have not been drawn
+        free_rects(g_invalidated_rects);
+        g_invalidated_rects = NULL;
+        free_rects(g_copied_rects);
+        g_copied_rects = NULL;
+        free_rects(g_pick_invalidated_rects);
+        g_pick_invalidated_rects = NULL;
+
+        // Delete the memory kept by the polygon rasterizer and the cached shapes
+        raster_ctx_release();
+        rounded_frame_cache_release();
+
+        // Delete the rendered texts and glyphs, before the fonts are released
+        text_cache_flush();
+        glyph_atlas_release();
 
         // Delete linked list classes
         ei_widgetclass_t *linked_list_classes = frame_class;
@@ -206,6 +435,7 @@ void ei_app_free(void){
         }
 
         free(linked_list_classes);
+        class_registry_release();
 
         // Release the hardware
         hw_quit();
@@ -231,6 +461,246 @@ ei_surface_t ei_app_root_surface(void){
         return g_root_windows;
 }
 
+/**
+ * \brief	Returns the number of mouse move events which were not treated because a more recent
+ *		mouse move was already waiting in the event queue. Only the last position of a run of
+ *		mouse moves is treated, the buttons pressed and released in between are kept.
+ *
+ * @return			The number of coalesced events since the application was created.
+ */
+uint32_t ei_app_coalesced_events(void){
+        return g_nb_coalesced_events;
+}
+
+/**
+ * \brief	Releases what the library keeps about a font. It must be called before the font is
+ *		freed by \ref hw_text_font_free, since a font created later may get the same address.
+ *
+ * @param	font		The font which is going to be freed.
+ */
+void ei_app_forget_font(ei_font_t font){
+        text_cache_forget_font(font);
+        glyph_atlas_forget(font);
+}
+
+/**
+ * @brief       Add a rectangle to a list of rectangles which never overlap. Rectangles which overlap are merged,
+ *              so that each pixel is drawn only once.
+ *
+ * @param       rects       The list of rectangles
+ * @param       rect        The rectangle to add, only its part inside the root window is kept
+ */
+static void add_rect(ei_linked_rect_t **rects, ei_rect_t rect) {
+        // Only the part of the rectangle which is inside the root window is useful
+        ei_rect_t damage = ei_rect_intersection(rect, hw_surface_get_rect(g_root_windows));
+        if (ei_rect_is_empty(damage)) return;
+
+        // Merge the damage with every rectangle it overlaps. A merged rectangle can overlap other ones,
+        // so the list is browsed again until there is no more overlap.
+        ei_bool_t has_merged;
+        do {
+                has_merged = EI_FALSE;
+                ei_linked_rect_t **current = rects;
+                while (*current) {
+                        if (!ei_rect_is_empty(ei_rect_intersection((*current)->rect, damage))) {
+                                ei_linked_rect_t *to_suppr = *current;
+                                damage = ei_rect_union(to_suppr->rect, damage);
+                                *current = to_suppr->next;
+                                free(to_suppr);
+                                has_merged = EI_TRUE;
+                        } else {
+                                current = &(*current)->next;
+                        }
+                }
+        } while (has_merged);
+
+        // Insert the damage on head of the list
+        ei_linked_rect_t *new_rect = malloc(sizeof(ei_linked_rect_t));
+        new_rect->rect = damage;
+        new_rect->next = *rects;
+        *rects = new_rect;
+}
+
+/**
+ * \brief	Adds a rectangle to the list of rectangles that must be updated on screen. The real
+ *		update on the screen will be done at the right moment in the main loop.
+ *		Rectangles which overlap are merged, so that each pixel is drawn only once.
+ *
+ * @param	rect		The rectangle to add, expressed in the root window coordinates.
+ *				A copy is made, so it is safe to release the rectangle on return.
+ */
+void ei_app_invalidate_rect(ei_rect_t* rect) {
+        if (!rect || !g_root_windows) return;
+
+        add_rect(&g_invalidated_rects, *rect);
+        g_needs_redraw = EI_TRUE;
+}
+
+/**
+ * \brief	Asks for a new frame. The regions given to \ref ei_app_invalidate_rect are drawn, or the
+ *		whole window if there is none. Frames are drawn at most once per frame interval (see
+ *		\ref ei_app_set_frame_interval), and never when nothing has been invalidated or requested.
+ */
+void ei_app_request_redraw(void) {
+        g_needs_redraw = EI_TRUE;
+}
+
+/**
+ * \brief	Sets the minimum time between two frames. The events received meanwhile are treated,
+ *		and their damaged regions are drawn together in the next frame.
+ *
+ * @param	interval	The interval, in seconds. Defaults to \ref EI_DEFAULT_FRAME_INTERVAL.
+ *				With 0, a frame is drawn after each event which damaged the window.
+ */
+void ei_app_set_frame_interval(double interval) {
+        g_frame_interval = interval > 0 ? interval : 0;
+}
+
+/**
+ * @brief       Translate a rectangle.
+ */
+static inline ei_rect_t rect_translate(ei_rect_t rect, ei_point_t shift) {
+        rect.top_left.x += shift.x;
+        rect.top_left.y += shift.y;
+        return rect;
+}
+
+/**
+ * @brief       Invalidate the part of a rectangle which is outside another one. It is split in at most four
+ *              rectangles: above, below, on the left and on the right of the other one.
+ *
+ * @param       rect        The rectangle to invalidate
+ * @param       hole        The part of the rectangle which must not be invalidated
+ */
+static void invalidate_difference(ei_rect_t rect, ei_rect_t hole) {
+        hole = ei_rect_intersection(rect, hole);
+        if (ei_rect_is_empty(hole)) {
+                ei_app_invalidate_rect(&rect);
+                return;
+        }
+
+        int rect_bottom = rect.top_left.y + rect.size.height;
+        int hole_bottom = hole.top_left.y + hole.size.height;
+        ei_rect_t parts[4] = {
+                {rect.top_left, {rect.size.width, hole.top_left.y - rect.top_left.y}},
+                {{rect.top_left.x, hole_bottom}, {rect.size.width, rect_bottom - hole_bottom}},
+                {{rect.top_left.x, hole.top_left.y}, {hole.top_left.x - rect.top_left.x, hole.size.height}},
+                {{hole.top_left.x + hole.size.width, hole.top_left.y},
+                 {rect.top_left.x + rect.size.width - hole.top_left.x - hole.size.width, hole.size.height}}
+        };
+        for (int i = 0 ; i < 4 ; ++i) {
+                if (!ei_rect_is_empty(parts[i])) ei_app_invalidate_rect(&parts[i]);
+        }
+}
+
+/**
+ * @brief       Update the window after a widget has been moved without changing its size nor its appearance, and
+ *              without invalidating its locations. The pixels of the widget which are visible on the window are
+ *              copied to its new location. Only the region it has uncovered, the parts of its new location which
+ *              were not visible before, and the widgets drawn over it are drawn again.
+ *              The widget must be opaque on its whole screen location, as the toplevels are.
+ *
+ * @param       widget          The widget, its screen location is the new one
+ * @param       old_location    The screen location of the widget before it was moved
+ */
+void move_widget_pixels(ei_widget_t *widget, ei_rect_t old_location) {
+        ei_rect_t new_location = widget->screen_location;
+        ei_point_t shift = {new_location.top_left.x - old_location.top_left.x,
+                            new_location.top_left.y - old_location.top_left.y};
+
+        // The pixels on the window can't be used if nothing has been drawn yet
+        if (!g_has_drawn_frame || new_location.size.width != old_location.size.width
+            || new_location.size.height != old_location.size.height) {
+                ei_app_invalidate_rect(&old_location);
+                ei_app_invalidate_rect(&new_location);
+                return;
+        }
+        if (shift.x == 0 && shift.y == 0) return;
+
+        // The widget is clipped by the content rect of its ancestors, which have not moved
+        ei_rect_t clipper = hw_surface_get_rect(g_root_windows);
+        for (ei_widget_t *ancestor = widget->parent ; ancestor != NULL ; ancestor = ancestor->parent) {
+                clipper = ei_rect_intersection(clipper, *ancestor->content_rect);
+        }
+        ei_rect_t old_visible = ei_rect_intersection(old_location, clipper);
+        ei_rect_t new_visible = ei_rect_intersection(new_location, clipper);
+
+        // Only the visible pixels which are still visible at their new location are copied
+        ei_point_t back = {-shift.x, -shift.y};
+        ei_rect_t source = ei_rect_intersection(old_visible, rect_translate(new_visible, back));
+        ei_rect_t destination = rect_translate(source, shift);
+        if (ei_rect_is_empty(source)) {
+                ei_app_invalidate_rect(&old_visible);
+                ei_app_invalidate_rect(&new_visible);
+                return;
+        }
+
+        // The copied pixels which were waiting to be drawn again are drawn again at their new location. The damaged
+        // rectangles are collected first, because invalidating a rectangle changes the list.
+        ei_linked_rect_t *moved_damage = NULL;
+        for (ei_linked_rect_t *damage = g_invalidated_rects ; damage != NULL ; damage = damage->next) {
+                ei_rect_t copied = ei_rect_intersection(damage->rect, source);
+                if (!ei_rect_is_empty(copied)) add_rect(&moved_damage, rect_translate(copied, shift));
+        }
+
+        ei_copy_surface_overlap(g_root_windows, &destination, &source);
+        add_rect(&g_copied_rects, destination);
+        g_needs_redraw = EI_TRUE;
+
+        for (ei_linked_rect_t *damage = moved_damage ; damage != NULL ; damage = damage->next) {
+                ei_app_invalidate_rect(&damage->rect);
+        }
+        free_rects(moved_damage);
+
+        // The uncovered region, and the part of the new location whose pixels were not visible
+        invalidate_difference(old_visible, new_visible);
+        invalidate_difference(new_visible, destination);
+
+        // The widgets drawn over the moved one hid some copied pixels, and are overwritten by the copy
+        for (ei_widget_t *branch = widget ; branch != g_root_frame ; branch = branch->parent) {
+                for (ei_widget_t *sibling = branch->next_sibling ; sibling != NULL ; sibling = sibling->next_sibling) {
+                        if (sibling->placer_params == NULL) continue;
+                        ei_rect_t hidden = ei_rect_intersection(sibling->screen_location, source);
+                        ei_rect_t overwritten = ei_rect_intersection(sibling->screen_location, destination);
+                        if (!ei_rect_is_empty(hidden)) {
+                                hidden = rect_translate(hidden, shift);
+                                ei_app_invalidate_rect(&hidden);
+                        }
+                        if (!ei_rect_is_empty(overwritten)) ei_app_invalidate_rect(&overwritten);
+                }
+        }
+}
+
+/**
+ * @brief       Add a rectangle to the region of the picking offscreen which must be drawn again, because the
+ *              geometry of the widgets (location, size, shape or stacking order) has changed there.
+ *              The offscreen is only updated when a widget is picked, see \ref update_pick_offscreen.
+ *
+ * @param       rect        The rectangle, expressed in the root window coordinates.
+ */
+void invalidate_geometry_rect(ei_rect_t *rect) {
+        if (!rect || !g_root_windows) return;
+
+        add_rect(&g_pick_invalidated_rects, *rect);
+        ++g_geometry_version;
+}
+
+/**
+ * @brief       Draw again the invalidated region of the picking offscreen, only if the geometry of the widgets
+ *              has changed since the last update.
+ */
+void update_pick_offscreen(void) {
+        if (g_pick_version == g_geometry_version) return;
+
+        for (ei_linked_rect_t *damage = g_pick_invalidated_rects ; damage != NULL ; damage = damage->next) {
+                draw_widgets(g_root_frame, NULL, g_offscreen, damage->rect);
+        }
+
+        free_rects(g_pick_invalidated_rects);
+        g_pick_invalidated_rects = NULL;
+        g_pick_version = g_geometry_version;
+}
+
 /**
  * \brief	Tells the application to quite. Is usually called by an event handler (for example
  *		when pressing the "Escape" key).
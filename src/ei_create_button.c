@@ -1,6 +1,97 @@
 #include "ei_create_button.h"
 #include "single_linked_list.h"
 
+/**
+ * @brief       Points of a rectangle with rounded edges, relative to its top-left corner.
+ */
+typedef struct rounded_shape {
+        ei_size_t               size;           ///< Size of the rectangle
+        uint32_t                radius;         ///< Radius of the roundings
+        ei_part_frame           part;           ///< Generated part of the rectangle
+        uint32_t                nb_points;      ///< Number of points, including the closing one
+        ei_point_t              points[ROUNDED_FRAME_MAX_POINTS];
+        struct rounded_shape*   next;           ///< Next shape of the same bucket
+} rounded_shape;
+
+// Tolerance on the coordinates of the points of a bow
+#define ARC_EPSILON 1e-9
+
+// Maximum distance between a bow and the segments which approximate it, in pixels
+#define ARC_MAX_DEVIATION 0.25
+
+// Number of buckets of the hash table of shapes, a power of two
+#define ROUNDED_FRAME_BUCKETS 256
+
+// Hash table of the shapes already computed
+static rounded_shape *g_shapes[ROUNDED_FRAME_BUCKETS];
+static uint32_t g_nb_shapes = 0;
+
+/**
+ * @brief       Return the number of segments of a bow, so that the distance between the bow and
+ *              its segments is at most ARC_MAX_DEVIATION.
+ *
+ * @param       radius          The bow radius.
+ * @param       angle           The angle covered by the bow.
+ *
+ * @return      The number of segments, between 1 and ARC_MAX_SEGMENTS.
+ */
+static uint32_t arc_nb_segments(uint32_t radius, double_t angle) {
+        if (radius <= ARC_MAX_DEVIATION) return 1;
+
+        // A chord of angle a is at radius * (1 - cos(a / 2)) from the bow at most
+        double_t max_angle = 2 * acos(1 - ARC_MAX_DEVIATION / radius);
+        double_t nb_segments = ceil(angle / max_angle);
+
+        if (nb_segments < 1) return 1;
+        if (nb_segments > ARC_MAX_SEGMENTS) return ARC_MAX_SEGMENTS;
+        return (uint32_t) nb_segments;
+}
+
+/**
+ * @brief       Write the points of a bow. A point is the center moved of the radius times the
+ *              cosinus and the sinus of its angle, rounded down. Rounding errors of cos and sin are
+ *              ignored, so that a point on an axis of the center is exactly on it.
+ *              The points between the ends are computed by rotating the previous one, the ends
+ *              are computed directly so that consecutive bows share them exactly.
+ *
+ * @param       points          Where to write the points, at most ARC_MAX_SEGMENTS + 1.
+ * @param       center          The bow center.
+ * @param       radius          The bow radius.
+ * @param       begin_angle     The angle where the bow start.
+ * @param       end_angle       The angle where the bow end.
+ *
+ * @return      The number of written points.
+ */
+static uint32_t arc_points(ei_point_t *points, ei_point_t center, uint32_t radius, double_t begin_angle, double_t end_angle) {
+        // Always the shortest path
+        while (end_angle < begin_angle) {
+                end_angle += 2*M_PI;
+        }
+
+        uint32_t nb_segments = arc_nb_segments(radius, end_angle - begin_angle);
+        double_t step = (end_angle - begin_angle) / nb_segments;
+        double_t cos_step = cos(step);
+        double_t sin_step = sin(step);
+
+        // Vector from the center to the current point
+        double_t x = radius * cos(begin_angle);
+        double_t y = radius * sin(begin_angle);
+
+        for (uint32_t i = 0; i < nb_segments; ++i) {
+                points[i].x = center.x + (int32_t) floor(x + ARC_EPSILON);
+                points[i].y = center.y + (int32_t) floor(-y + ARC_EPSILON);
+
+                // Rotation of the step angle
+                double_t next_x = x * cos_step - y * sin_step;
+                y = x * sin_step + y * cos_step;
+                x = next_x;
+        }
+
+        points[nb_segments].x = center.x + (int32_t) floor(radius * cos(end_angle) + ARC_EPSILON);
+        points[nb_segments].y = center.y + (int32_t) floor(-(radius * sin(end_angle)) + ARC_EPSILON);
+        return nb_segments + 1;
+}
+
 /**
  * @brief       Generate a linked list of points which represent a bow.
  *              The linked list is malloc so it must be free by the user of this function.
@@ -16,36 +107,106 @@ ei_linked_point_t*       arc                     (ei_point_t             center,
                                                  uint32_t               radius,
                                                  double_t               begin_angle,
                                                  double_t               end_angle) {
-        // Init linked list
-        ei_linked_point_t *ll = malloc(sizeof(ei_linked_point_t));
-        ei_linked_point_t *head_list = ll;
+        ei_point_t points[ARC_MAX_SEGMENTS + 1];
+        uint32_t nb_points = arc_points(points, center, radius, begin_angle, end_angle);
+
+        // Init linked list, from the last point to the first one
+        ei_linked_point_t *head_list = NULL;
+        for (uint32_t i = nb_points ; i > 0 ; --i) {
+                ei_linked_point_t *new_point = malloc(sizeof(ei_linked_point_t));
+                new_point->point = points[i - 1];
+                new_point->next = head_list;
+                head_list = new_point;
+        }
+        return head_list;
+}
 
-        // Always the shortest path
-        while (end_angle < begin_angle) {
-                end_angle += 2*M_PI;
+/**
+ * @brief       Compute the points of a rectangle with rounded edges placed at (0, 0).
+ *
+ * @param       shape       The shape, its size, radius and part are already filled.
+ */
+static void compute_shape(rounded_shape *shape) {
+        int32_t width = shape->size.width;
+        int32_t height = shape->size.height;
+        int32_t radius = (int32_t) shape->radius;
+        int32_t h = height >= width ? width / 2 : height / 2;
+
+        ei_point_t top_left = {radius, radius};
+        ei_point_t top_right = {width - radius, radius};
+        ei_point_t bottom_left = {radius, height - radius};
+        ei_point_t bottom_right = {width - radius, height - radius};
+
+        // Points in center, between the top and the bottom parts
+        ei_point_t p_right = {width - h, h};
+        ei_point_t p_left = {h, height - h};
+
+        ei_point_t *points = shape->points;
+        uint32_t n = 0;
+        switch (shape->part) {
+                case FULL:
+                        n += arc_points(points + n, bottom_left, shape->radius, M_PI, (3*M_PI)/2);
+                        n += arc_points(points + n, bottom_right, shape->radius, (3*M_PI)/2, 0);
+                        n += arc_points(points + n, top_right, shape->radius, 0, M_PI/2);
+                        n += arc_points(points + n, top_left, shape->radius, M_PI/2, M_PI);
+                        break;
+                case BOTTOM:
+                        n += arc_points(points + n, bottom_left, shape->radius, 5*M_PI/4, (3*M_PI)/2);
+                        n += arc_points(points + n, bottom_right, shape->radius, (3*M_PI)/2, 0);
+                        n += arc_points(points + n, top_right, shape->radius, 0, M_PI/4);
+                        points[n++] = p_right;
+                        points[n++] = p_left;
+                        break;
+                case TOP:
+                        n += arc_points(points + n, top_left, shape->radius, M_PI/2, M_PI);
+                        n += arc_points(points + n, bottom_left, shape->radius, M_PI, (5*M_PI)/4);
+                        points[n++] = p_left;
+                        points[n++] = p_right;
+                        n += arc_points(points + n, top_right, shape->radius, M_PI/4, M_PI/2);
+                        break;
         }
 
-        // Init first point of linked list
-        ll->point.x = (int32_t) (center.x + radius * cos(begin_angle));
-        ll->point.y = (int32_t) (center.y - radius * sin(begin_angle));
-        ll->next = NULL;
+        // Link the last point to the first one
+        points[n++] = points[0];
+        shape->nb_points = n;
+}
 
-        // Number points to calculate
-        uint32_t nb_points = 20;
+/**
+ * @brief       Return the shape of a rectangle with rounded edges, it is computed if it is not in the cache.
+ *
+ * @param       size            The size of the rectangle.
+ * @param       rounded_radius  The radius of roundings.
+ * @param       part            The part of rectangle which must be generated.
+ *
+ * @return      The shape, owned by the cache.
+ */
+static const rounded_shape *get_shape(ei_size_t size, uint32_t rounded_radius, ei_part_frame part) {
+        uint32_t hash = ((uint32_t) size.width * 73856093u) ^ ((uint32_t) size.height * 19349663u)
+                        ^ (rounded_radius * 83492791u) ^ (uint32_t) part;
+        rounded_shape **bucket = &g_shapes[hash & (ROUNDED_FRAME_BUCKETS - 1)];
+
+        for (rounded_shape *shape = *bucket ; shape != NULL ; shape = shape->next) {
+                if (shape->size.width == size.width && shape->size.height == size.height
+                    && shape->radius == rounded_radius && shape->part == part) {
+                        return shape;
+                }
+        }
 
-        for (uint32_t i = 1; i <= nb_points; ++i) {
-                ei_linked_point_t *next_point = malloc(sizeof(ei_linked_point_t));
+        // The cache is emptied when it is full, sizes change a lot only while resizing
+        if (g_nb_shapes >= ROUNDED_FRAME_CACHE_SIZE) {
+                rounded_frame_cache_release();
+        }
 
-                // Calcul of the next point
-                double_t angle = begin_angle + i * ((end_angle - begin_angle)/ nb_points);
-                next_point->point.x = (int32_t) (center.x + radius * cos(angle));
-                next_point->point.y = (int32_t) (center.y - radius * sin(angle));
-                next_point->next = NULL;
+        rounded_shape *shape = malloc(sizeof(rounded_shape));
+        shape->size = size;
+        shape->radius = rounded_radius;
+        shape->part = part;
+        compute_shape(shape);
 
-                ll->next = next_point;
-                ll = next_point;
-        }
-        return head_list;
+        shape->next = *bucket;
+        *bucket = shape;
+        ++g_nb_shapes;
+        return shape;
 }
 
 /**
@@ -62,139 +223,59 @@ ei_linked_point_t*       arc                     (ei_point_t             center,
 ei_linked_point_t*       rounded_frame           (ei_rect_t              rectangle,
                                                  uint32_t                  rounded_radius,
                                                   ei_part_frame           part) {
-        int32_t x0 = rectangle.top_left.x;
-        int32_t y0 = rectangle.top_left.y;
-
-        uint32_t h;
-        if (rectangle.size.height >= rectangle.size.width) {
-                h = rectangle.size.width / 2;
-        } else {
-                h = rectangle.size.height / 2;
+        ei_point_t points[ROUNDED_FRAME_MAX_POINTS];
+        uint32_t nb_points = rounded_frame_cached(rectangle, rounded_radius, part, points);
+
+        // Each point must be freed by free_list, so they are copied in separate nodes
+        ei_linked_point_t *head_list = NULL;
+        ei_linked_point_t **link = &head_list;
+        for (uint32_t i = 0 ; i < nb_points ; ++i) {
+                *link = malloc(sizeof(ei_linked_point_t));
+                (*link)->point = points[i];
+                (*link)->next = NULL;
+                link = &(*link)->next;
         }
+        return head_list;
+}
 
-        // Declare center var
-        ei_point_t center;
-
-        if (part != TOP) {
-                // Case bottom and full
-
-                // Bottom right corner
-                center.x = x0 + rectangle.size.width - rounded_radius;
-                center.y = y0 + rectangle.size.height - rounded_radius;
-                ei_linked_point_t *ll_arc_bottom_right = arc(center, rounded_radius, (3*M_PI)/2, 0);
-                ei_linked_point_t *end_point_bottom_right = get_last_node(ll_arc_bottom_right);
-
-                if (part == FULL) {
-                        // Top left corner
-                        center.x = x0 + rounded_radius;
-                        center.y = y0 + rounded_radius;
-                        ei_linked_point_t *ll_arc_top_left = arc(center, rounded_radius, M_PI/2, M_PI);
-                        ei_linked_point_t *end_point_top_left = get_last_node(ll_arc_top_left);
-
-                        // Bottom left corner
-                        center.x = x0 + rounded_radius;
-                        center.y = y0 + rectangle.size.height - rounded_radius;
-                        ei_linked_point_t *ll_arc_bottom_left = arc(center, rounded_radius, M_PI, (3*M_PI)/2);
-                        ei_linked_point_t *end_point_bottom_left = get_last_node(ll_arc_bottom_left);
-
-                        // Top right corner
-                        center.x = x0 + rectangle.size.width - rounded_radius;
-                        center.y = y0 + rounded_radius;
-                        ei_linked_point_t *ll_arc_top_right = arc(center, rounded_radius, 0, M_PI/2);
-                        ei_linked_point_t *end_point_top_right = get_last_node(ll_arc_top_right);
-
-                        // Link each corner linked list
-                        end_point_bottom_left->next = ll_arc_bottom_right;
-                        end_point_bottom_right->next = ll_arc_top_right;
-                        end_point_top_right->next = ll_arc_top_left;
-
-                        // Link the last point to the first one
-                        ei_linked_point_t *last_point = malloc(sizeof(ei_linked_point_t));
-                        *last_point = *ll_arc_bottom_left;
-                        last_point->next = NULL;
-                        end_point_top_left->next = last_point;
-                        return ll_arc_bottom_left;
-                } else {
-                        // Case bottom
-
-                        // Mid bottom left corner
-                        center.x = x0 + rounded_radius;
-                        center.y = y0 + rectangle.size.height - rounded_radius;
-                        ei_linked_point_t *ll_arc_mid_bottom_left = arc(center, rounded_radius, 5*M_PI/4, (3*M_PI)/2);
-                        ei_linked_point_t *end_point_mid_bottom_left = get_last_node(ll_arc_mid_bottom_left);
-
-                        // Mid top right corner
-                        center.x = x0 + rectangle.size.width - rounded_radius;
-                        center.y = y0 + rounded_radius;
-                        ei_linked_point_t *ll_arc_mid_top_right = arc(center, rounded_radius, 0, M_PI/4);
-                        ei_linked_point_t *end_point_mid_top_right = get_last_node(ll_arc_mid_top_right);
-
-                        // Points in center
-                        ei_linked_point_t *p_right = malloc(sizeof(ei_linked_point_t));
-                        p_right->point.x = x0 + rectangle.size.width - h;
-                        p_right->point.y = y0 + h;
-
-                        ei_linked_point_t *p_left = malloc(sizeof(ei_linked_point_t));
-                        p_left->point.x = x0 + h;
-                        p_left->point.y = y0 + rectangle.size.height - h;
-
-                        // Link each corner linked list
-                        end_point_mid_bottom_left->next = ll_arc_bottom_right;
-                        end_point_bottom_right->next = ll_arc_mid_top_right;
-                        end_point_mid_top_right->next = p_right;
-                        p_right->next = p_left;
-
-                        // Link the last point to the first one
-                        ei_linked_point_t *last_point = malloc(sizeof(ei_linked_point_t));
-                        *last_point = *ll_arc_mid_bottom_left;
-                        last_point->next = NULL;
-                        p_left->next = last_point;
-                        return ll_arc_mid_bottom_left;
-                }
+/**
+ * @brief       Same as \ref rounded_frame, but the points are written in an array given by the caller,
+ *              so that nothing is allocated. The shape of each (size, radius, part) is computed once,
+ *              then it is only translated to the position of the rectangle.
+ *
+ * @param       rectangle           The rectangle (size and top-left position) which must be rounded.
+ * @param       rounded_radius      The radius of roundings.
+ * @param       part                The part of rectangle which must be generated.
+ * @param       points              The array where the points are written, the last one is the same as
+ *                                  the first one. It must contain at least \ref ROUNDED_FRAME_MAX_POINTS points.
+ *
+ * @return      The number of written points.
+ */
+uint32_t                rounded_frame_cached    (ei_rect_t              rectangle,
+                                                 uint32_t                rounded_radius,
+                                                 ei_part_frame           part,
+                                                 ei_point_t*             points) {
+        const rounded_shape *shape = get_shape(rectangle.size, rounded_radius, part);
+
+        for (uint32_t i = 0 ; i < shape->nb_points ; ++i) {
+                points[i].x = shape->points[i].x + rectangle.top_left.x;
+                points[i].y = shape->points[i].y + rectangle.top_left.y;
+        }
+        return shape->nb_points;
+}
 
-        } else {
-                // Case top
-
-                // Top left corner
-                center.x = x0 + rounded_radius;
-                center.y = y0 + rounded_radius;
-                ei_linked_point_t *ll_arc_top_left = arc(center, rounded_radius, M_PI/2, M_PI);
-                ei_linked_point_t *end_point_top_left = get_last_node(ll_arc_top_left);
-
-                // Mid bottom left corner
-                center.x = x0 + rounded_radius;
-                center.y = y0 + rectangle.size.height - rounded_radius;
-                ei_linked_point_t *ll_arc_mid_bottom_left = arc(center, rounded_radius, M_PI, (5*M_PI)/4);
-                ei_linked_point_t *end_point_mid_bottom_left = get_last_node(ll_arc_mid_bottom_left);
-
-                // Points in center
-                ei_linked_point_t *p_left = malloc(sizeof(ei_linked_point_t));
-                p_left->point.x = x0 + h;
-                p_left->point.y = y0 + rectangle.size.height - h;
-
-                ei_linked_point_t *p_right = malloc(sizeof(ei_linked_point_t));
-                p_right->point.x = x0 + rectangle.size.width - h;
-                p_right->point.y = y0 + h;
-
-                // Mid top right corner
-                center.x = x0 + rectangle.size.width - rounded_radius;
-                center.y = y0 + rounded_radius;
-                ei_linked_point_t *ll_arc_mid_top_right = arc(center, rounded_radius, M_PI/4, M_PI/2);
-                ei_linked_point_t *end_point_mid_top_right = get_last_node(ll_arc_mid_top_right);
-
-                // Link each corner linked list
-                end_point_top_left->next = ll_arc_mid_bottom_left;
-                end_point_mid_bottom_left->next = p_left;
-                p_left->next = p_right;
-                p_right->next = ll_arc_mid_top_right;
-
-                // Link the last point to the first one
-                ei_linked_point_t *last_point = malloc(sizeof(ei_linked_point_t));
-                *last_point = *ll_arc_top_left;
-                last_point->next = NULL;
-                end_point_mid_top_right->next = last_point;
-                return ll_arc_top_left;
+/**
+ * @brief       Forget all the shapes computed by \ref rounded_frame_cached.
+ */
+void rounded_frame_cache_release(void) {
+        for (uint32_t i = 0 ; i < ROUNDED_FRAME_BUCKETS ; ++i) {
+                while (g_shapes[i] != NULL) {
+                        rounded_shape *to_suppr = g_shapes[i];
+                        g_shapes[i] = to_suppr->next;
+                        free(to_suppr);
+                }
         }
+        g_nb_shapes = 0;
 }
 
 /**
@@ -268,3 +349,20 @@ ei_linked_point_t *get_rectangle_list (ei_rect_t rectangle) {
         return ll;
 }
 
+
+/**
+ * @brief       Same as \ref get_rectangle_list, but the points are written in an array given by the caller.
+ *
+ * @param       rectangle       The rectangle (size and top-left position) which must be generated.
+ * @param       points          The array where the 5 points are written, the last one is the same as the first one.
+ */
+void rectangle_points (ei_rect_t rectangle, ei_point_t *points) {
+        int32_t x_max = rectangle.top_left.x + rectangle.size.width;
+        int32_t y_max = rectangle.top_left.y + rectangle.size.height;
+
+        points[0] = rectangle.top_left;
+        points[1] = ei_point(x_max, rectangle.top_left.y);
+        points[2] = ei_point(x_max, y_max);
+        points[3] = ei_point(rectangle.top_left.x, y_max);
+        points[4] = rectangle.top_left;
+}
@@ -1,62 +1,48 @@
+#include <string.h>
+
 #include "ei_draw.h"
+#include "ei_utils.h"
 #include "single_linked_list.h"
+#include "raster_ctx.h"
+#include "pixel_kernels.h"
+#include "text_cache.h"
 #include "ei_create_button.h"
 #include "widget_manager.h"
 
 /**
- * @brief       Return if a point is in a certain area which is the clipper
+ * @brief       Integer division rounded down (towards minus infinity), the divisor must be positive.
  *
- * @param       point_x
- * @param       point_y
- * @param       x_max
- * @param       y_max
- * @param       clipper     The clipper, it could be NULL.
+ * @param       a           The dividend
+ * @param       b           The divisor
  *
- * @return      True if point given in param is in clipper, False if not.
+ * @return      The largest integer q such as q * b <= a.
  */
-static int is_in_clipper(int point_x, int point_y, const ei_rect_t* clipper) {
-        if (clipper) {
-                // Max coordinates of the clipper
-                uint32_t x_max = clipper->top_left.x + clipper->size.width;
-                uint32_t y_max = clipper->top_left.y + clipper->size.height;
+static inline int32_t floor_div(int32_t a, int32_t b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
 
-                return (point_x <= x_max) && (point_y <= y_max) && (point_x >= clipper->top_left.x) && (point_y >= clipper->top_left.y);
-        }
-        // If there is no clipper, it means that the point could be display
-        return EI_TRUE;
+/**
+ * @brief       Same as floor_div, on 64 bits integers.
+ */
+static inline int64_t floor_div64(int64_t a, int64_t b) {
+        return a >= 0 ? a / b : -((-a + b - 1) / b);
 }
 
 /**
- * @brief       Do a clipping on the content_rect of the widget given in parameter.
- *              This function could be used when the content_rect of parent's widget is smaller than its.
+ * @brief       Return the visible part of the content_rect of the widget given in parameter.
+ *              This function could be used when the content_rect of parent's widget is smaller than its,
+ *              or when only a part of the widget must be redrawn.
+ *
+ * @param       widget      The widget which content_rect is clipped. It is not modified.
+ * @param       clipper     The clipper. Could be NULL.
  *
- * @param       widget      The widget where the content_rect attribute must be updated.
- * @param       clipper     The new clipper. Could be NULL.
+ * @return      The intersection of the content_rect and the clipper.
  */
-static void clipper_content_rect(ei_widget_t *widget, ei_rect_t *clipper) {
+static ei_rect_t clipper_content_rect(ei_widget_t *widget, const ei_rect_t *clipper) {
         if (clipper) {
-                // Update width
-                if (widget->content_rect->size.width > clipper->size.width) {
-                        widget->content_rect->size.width = clipper->size.width;
-                }
-
-                // Update height
-                if (widget->content_rect->size.height > clipper->size.height) {
-                        widget->content_rect->size.height = clipper->size.height;
-                }
-
-                // Update top-left x coordinate
-                if (widget->content_rect->top_left.x < clipper->top_left.x) {
-                        widget->content_rect->size.width += widget->content_rect->top_left.x - clipper->top_left.x;
-                        widget->content_rect->top_left.x = clipper->top_left.x;
-                }
-
-                // Update top-left y coordinate
-                if (widget->content_rect->top_left.y < clipper->top_left.y) {
-                        widget->content_rect->size.height += widget->content_rect->top_left.y - clipper->top_left.y;
-                        widget->content_rect->top_left.y = clipper->top_left.y;
-                }
+                return ei_rect_intersection(*widget->content_rect, *clipper);
         }
+        return *widget->content_rect;
 }
 
 /**
@@ -80,18 +66,144 @@ uint32_t		ei_map_rgba		(ei_surface_t surface, ei_color_t color) {
 
         hw_surface_get_channel_indices(surface, &red_place, &green_place, &blue_place, &alpha_place);
 
-        uint32_t *color_int = malloc(sizeof(uint32_t));
-        uint8_t *p = (uint8_t *) color_int;
+        uint32_t color_int;
+        uint8_t *p = (uint8_t *) &color_int;
 
         p[blue_place] = color.blue;
         p[red_place] = color.red;
         p[green_place] = color.green;
         p[6 - (blue_place + red_place + green_place)] = color.alpha;
 
-        uint32_t color_return = *color_int;
-        free(color_int);
+        return color_int;
+}
+
+/**
+ * @brief       Draw a segment, both ends included, with Bresenham algorithm. The segment is clipped before
+ *              being drawn, so that only its pixels which are in the drawing rectangle are visited.
+ *              The pixels are the same as if the whole segment was drawn: the one of step t along the major
+ *              axis is moved of round(t * minor_length / major_length) on the minor axis.
+ *
+ * @param       first_pixel     The first pixel of the surface
+ * @param       width           The width of the surface
+ * @param       p1              The first end of the segment
+ * @param       p2              The last end of the segment
+ * @param       color           The color, already mapped with ei_map_rgba
+ * @param       draw_rect       The drawing rectangle, it must be inside the surface and not empty.
+ */
+static void draw_segment(uint32_t *first_pixel, int32_t width, ei_point_t p1, ei_point_t p2, uint32_t color,
+                         ei_rect_t draw_rect) {
+        // Bounds of the drawing rectangle (included)
+        int32_t x_min = draw_rect.top_left.x;
+        int32_t x_max = draw_rect.top_left.x + draw_rect.size.width - 1;
+        int32_t y_min = draw_rect.top_left.y;
+        int32_t y_max = draw_rect.top_left.y + draw_rect.size.height - 1;
+
+        // Both ends are on the same outer side of the drawing rectangle, nothing is drawn
+        if ((p1.x < x_min && p2.x < x_min) || (p1.x > x_max && p2.x > x_max)
+            || (p1.y < y_min && p2.y < y_min) || (p1.y > y_max && p2.y > y_max)) {
+                return;
+        }
+
+        // Horizontal segment, a span is written
+        if (p1.y == p2.y) {
+                int32_t begin = p1.x < p2.x ? p1.x : p2.x;
+                int32_t end = p1.x < p2.x ? p2.x : p1.x;
+                begin = begin > x_min ? begin : x_min;
+                end = end < x_max ? end : x_max;
+                fill_span(first_pixel + p1.y * width + begin, color, end - begin + 1);
+                return;
+        }
+
+        // Vertical segment, one pixel is written on each line
+        if (p1.x == p2.x) {
+                int32_t begin = p1.y < p2.y ? p1.y : p2.y;
+                int32_t end = p1.y < p2.y ? p2.y : p1.y;
+                begin = begin > y_min ? begin : y_min;
+                end = end < y_max ? end : y_max;
+                uint32_t *pixel = first_pixel + begin * width + p1.x;
+                for (int32_t y = begin ; y <= end ; ++y, pixel += width) {
+                        *pixel = color;
+                }
+                return;
+        }
 
-        return color_return;
+        // The major axis is the one along which the segment is the longest, one pixel is drawn at each step on it
+        int64_t dx = (int64_t) p2.x - p1.x;
+        int64_t dy = (int64_t) p2.y - p1.y;
+        int32_t x_sign = dx > 0 ? 1 : -1;
+        int32_t y_sign = dy > 0 ? 1 : -1;
+        ei_bool_t x_major = (dx * x_sign) >= (dy * y_sign);
+
+        int64_t major_length = x_major ? dx * x_sign : dy * y_sign;
+        int64_t minor_length = x_major ? dy * y_sign : dx * x_sign;
+
+        // Offsets along each axis from the first end, in the direction of the segment, which are in the drawing rectangle
+        int64_t x_first = x_sign > 0 ? x_min - p1.x : p1.x - x_max;
+        int64_t x_last = x_sign > 0 ? x_max - p1.x : p1.x - x_min;
+        int64_t y_first = y_sign > 0 ? y_min - p1.y : p1.y - y_max;
+        int64_t y_last = y_sign > 0 ? y_max - p1.y : p1.y - y_min;
+        int64_t major_first = x_major ? x_first : y_first;
+        int64_t major_last = x_major ? x_last : y_last;
+        int64_t minor_first = x_major ? y_first : x_first;
+        int64_t minor_last = x_major ? y_last : x_last;
+
+        // Clip the steps t in [0, major_length]: the major offset is t, the minor offset is
+        // floor((2 * t * minor_length + major_length) / (2 * major_length)), which increases with t
+        int64_t two_major = 2 * major_length;
+        int64_t two_minor = 2 * minor_length;
+        int64_t t_first = major_first > 0 ? major_first : 0;
+        int64_t t_last = major_last < major_length ? major_last : major_length;
+
+        int64_t t_minor_first = -floor_div64(-(two_major * minor_first - major_length), two_minor);
+        int64_t t_minor_last = -floor_div64(-(two_major * (minor_last + 1) - major_length), two_minor) - 1;
+        t_first = t_minor_first > t_first ? t_minor_first : t_first;
+        t_last = t_minor_last < t_last ? t_minor_last : t_last;
+        if (t_first > t_last) return;
+
+        // State of Bresenham algorithm at the first visible step
+        int64_t numerator = t_first * two_minor + major_length;
+        int64_t minor_offset = numerator / two_major;
+        int64_t error = numerator - minor_offset * two_major;
+
+        int32_t x = p1.x + x_sign * (int32_t) (x_major ? t_first : minor_offset);
+        int32_t y = p1.y + y_sign * (int32_t) (x_major ? minor_offset : t_first);
+        uint32_t *pixel = first_pixel + y * width + x;
+        intptr_t major_stride = x_major ? x_sign : (intptr_t) y_sign * width;
+        intptr_t minor_stride = x_major ? (intptr_t) y_sign * width : x_sign;
+
+        // Every pixel is in the drawing rectangle, the move on the minor axis is done with masks
+        for (int64_t t = t_first ; t <= t_last ; ++t) {
+                *pixel = color;
+                pixel += major_stride;
+                error += two_minor;
+                int64_t carry = -(int64_t) (error >= two_major);
+                error -= carry & two_major;
+                pixel += carry & minor_stride;
+        }
+}
+
+/**
+ * @brief       Copy the points of a linked list in the point buffer of the rasterizer context.
+ *
+ * @param       first_point     The head of the linked list, it can be NULL.
+ * @param       nb_points       Where to write the number of points.
+ *
+ * @return      The points, owned by the rasterizer context.
+ */
+static const ei_point_t *list_to_points(const ei_linked_point_t *first_point, uint32_t *nb_points) {
+        uint32_t n = 0;
+        for (const ei_linked_point_t *current_point = first_point ; current_point != NULL ; current_point = current_point->next) {
+                ++n;
+        }
+
+        ei_point_t *points = raster_ctx_points(raster_ctx_get(), n);
+        n = 0;
+        for (const ei_linked_point_t *current_point = first_point ; current_point != NULL ; current_point = current_point->next) {
+                points[n++] = current_point->point;
+        }
+
+        *nb_points = n;
+        return points;
 }
 
 /**
@@ -110,231 +222,51 @@ void			ei_draw_polyline	(ei_surface_t			surface,
                                                      const ei_linked_point_t*	first_point,
                                                      ei_color_t			color,
                                                      const ei_rect_t*		clipper) {
+        if (first_point == NULL) return;
+
+        uint32_t nb_points;
+        const ei_point_t *points = list_to_points(first_point, &nb_points);
+        ei_draw_polyline_n(surface, points, nb_points, color, clipper);
+}
+
+/**
+ * \brief	Same as \ref ei_draw_polyline, but the points are given in an array.
+ *
+ * @param	surface 	Where to draw the line. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	points	 	The points of the polyline.
+ * @param	nb_points	The number of points. It can be 0 (i.e. draws nothing), 1, or more.
+ * @param	color		The color used to draw the line. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void			ei_draw_polyline_n	(ei_surface_t			surface,
+                                                     const ei_point_t*		points,
+                                                     uint32_t			nb_points,
+                                                     ei_color_t			color,
+                                                     const ei_rect_t*		clipper) {
+        if (nb_points == 0) return;
+
         hw_surface_lock(surface);
         uint32_t *first_pixel = (uint32_t*)hw_surface_get_buffer(surface);
         ei_size_t size = hw_surface_get_size(surface);
 
+        // The drawing is restricted to the part of the clipper which is in the surface
+        ei_rect_t draw_rect = hw_surface_get_rect(surface);
+        if (clipper) {
+                draw_rect = ei_rect_intersection(draw_rect, *clipper);
+        }
 
-        if (first_point != NULL) {
+        if (!ei_rect_is_empty(draw_rect)) {
                 // Get int color
                 uint32_t color_int = ei_map_rgba(surface, color);
 
-                if (first_point->next == NULL) {
-                        // Case only one point
-                        if (is_in_clipper(first_point->point.x, first_point->point.y, clipper)) {
-                                first_pixel[first_point->point.x + first_point->point.y * size.width] = color_int;
-                        }
+                if (nb_points == 1) {
+                        // Case only one point, it is drawn as a segment of length 0
+                        draw_segment(first_pixel, size.width, points[0], points[0], color_int, draw_rect);
                 } else {
                         // Case with few points
-                        int32_t dx, dy, e;
-                        while (first_point->next != NULL) {
-                                ei_point_t p1 = first_point->point;
-                                ei_point_t p2 = first_point->next->point;
-
-                                dx = p2.x - p1.x;
-                                dy = p2.y - p1.y;
-
-                                if (dx != 0) {
-                                        if (dx > 0) {
-                                                if (dy != 0) {
-                                                        // 1st frame
-                                                        if (dy > 0) {
-                                                                // Diagonal/oblique 1st octant vector
-                                                                if (dx >= dy) {
-                                                                        e = dx;
-                                                                        dx = e * 2;
-                                                                        dy *= 2;
-
-                                                                        do {
-                                                                                ++p1.x;
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-
-                                                                                e -= dy;
-                                                                                if (e < 0) {
-                                                                                        ++p1.y;
-                                                                                        e += dx;
-                                                                                }
-                                                                        } while (p1.x != p2.x);
-                                                                // Vector close to vertical 2nd octant
-                                                                } else {
-                                                                        e = dy;
-                                                                        dy = e * 2;
-                                                                        dx *= 2;
-                                                                        // Draw the line
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                ++p1.y;
-                                                                                e -= dx;
-                                                                                if (e < 0) {
-                                                                                        ++p1.x;
-                                                                                        e += dy;
-                                                                                }
-                                                                        } while (p1.y != p2.y);
-                                                                }
-                                                        // Oblique 4th frame vector
-                                                        } else {
-                                                                // Diagonal/oblique 8th octant vector
-                                                                if (dx >= -dy) {
-                                                                        e = dx;
-                                                                        dx = e * 2;
-                                                                        dy *= 2;
-                                                                        // Draw the line
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                ++p1.x;
-                                                                                e += dy;
-                                                                                if (e < 0) {
-                                                                                        --p1.y;
-                                                                                        e += dx;
-                                                                                }
-                                                                        } while (p1.x != p2.x);
-                                                                // Vector close to vertical 7th octant
-                                                                } else {
-                                                                        e = dy;
-                                                                        dy = e * 2;
-                                                                        dx *= 2;
-                                                                        // Draw the line
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                --p1.y;
-                                                                                e += dx;
-                                                                                if (e > 0) {
-                                                                                        ++p1.x;
-                                                                                        e += dy;
-                                                                                }
-                                                                        } while (p1.y != p2.y);
-                                                                }
-                                                        }
-                                                // Right horizontal vector
-                                                } else {
-                                                        // Draw the line
-                                                        do {
-                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                }
-                                                                ++p1.x;
-                                                        } while (p1.x != p2.x);
-                                                }
-                                        // Case dx < 0
-                                        } else {
-                                                // Case dy != 0
-                                                if (dy != 0) {
-                                                        // We write in the 2nd cadran
-                                                        if (dy > 0) {
-
-                                                                if (-dx >= dy) {
-                                                                        e = dx;
-                                                                        dx *= 2;
-                                                                        dy *= 2;
-                                                                        // Draw the line
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                p1.x--;
-                                                                                if ((e += dy) >= 0) {
-                                                                                        p1.y++;
-                                                                                        e += dx;
-                                                                                }
-                                                                        } while (p1.x != p2.x);
-                                                                }
-                                                                // We write in the 3rd octant
-                                                                else {
-                                                                        e = dy;
-                                                                        dy *= 2;
-                                                                        dx *= 2;
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                p1.y++;
-                                                                                if ((e += dx) <= 0) {
-                                                                                        p1.x--;
-                                                                                        e += dy;
-                                                                                }
-                                                                        } while (p1.y != p2.y);
-                                                                }
-                                                        }
-                                                        // Case dy < 0, we write in the 3rd cadran
-                                                        else {
-                                                                if (dx <= dy) {
-                                                                        e = dx;
-                                                                        dx *= 2;
-                                                                        dy *= 2;
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                p1.x--;
-                                                                                if ((e -= dy) >= 0) {
-                                                                                        p1.y--;
-                                                                                        e += dx;
-                                                                                }
-                                                                        } while (p1.x != p2.x);
-                                                                } else {
-                                                                        e = dy;
-                                                                        dy *= 2;
-                                                                        dx *= 2;
-                                                                        do {
-                                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                                }
-                                                                                p1.y--;
-                                                                                if ((e -= dx) >= 0) {
-                                                                                        p1.x--;
-                                                                                        e += dy;
-                                                                                }
-                                                                        } while (p1.y != p2.y);
-                                                                }
-                                                        }
-                                                } else {
-                                                        // Case dy = 0 and dx < 0
-                                                        do {
-                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                }
-                                                                p1.x--;
-                                                        } while (p1.x != p2.x);
-                                                }
-                                        }
-                                } else {
-                                        dy = p2.y - p1.y;
-                                        if (dy != 0) {
-                                                // Increasing vertical vector
-                                                if (dy > 0) {
-                                                        // Draw the line
-                                                        do {
-                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                }
-                                                                ++p1.y;
-                                                        } while (p1.y != p2.y);
-                                                } else {
-                                                        // Draw the line
-                                                        do {
-                                                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                                                }
-                                                                --p1.y;
-                                                        } while (p1.y != p2.y);
-                                                }
-                                        }
-                                }
-                                // Draw the final pixel
-                                if (is_in_clipper(p1.x, p1.y, clipper)){
-                                        first_pixel[p1.x + p1.y * size.width] = color_int;
-                                }
-
-                                // Go to the next point of the list
-                                first_point = first_point->next;
+                        for (uint32_t i = 0 ; i + 1 < nb_points ; ++i) {
+                                draw_segment(first_pixel, size.width, points[i], points[i + 1], color_int, draw_rect);
                         }
                 }
         }
@@ -358,60 +290,106 @@ void			ei_draw_polygon		(ei_surface_t			surface,
                                                             const ei_linked_point_t*	first_point,
                                                             ei_color_t			color,
                                                             const ei_rect_t*		clipper) {
+        if (first_point == NULL) return;
+
+        uint32_t nb_points;
+        const ei_point_t *points = list_to_points(first_point, &nb_points);
+        ei_draw_polygon_n(surface, points, nb_points, color, clipper);
+}
+
+/**
+ * \brief	Same as \ref ei_draw_polygon, but the points are given in an array.
+ *
+ * @param	surface 	Where to draw the polygon. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	points	 	The points of the polygon. The last point is implicitly connected
+ *				to the first point.
+ * @param	nb_points	The number of points. It is either 0 (i.e. draws nothing), or more than 2.
+ * @param	color		The color used to draw the polygon. The alpha channel is managed.
+ * @param	clipper		If not NULL, the drawing is restricted within this rectangle.
+ */
+void			ei_draw_polygon_n	(ei_surface_t			surface,
+                                                     const ei_point_t*		points,
+                                                     uint32_t			nb_points,
+                                                     ei_color_t			color,
+                                                     const ei_rect_t*		clipper) {
+        if (nb_points == 0) return;
+
         // Get surface parameters
         hw_surface_lock(surface);
         uint32_t *first_pixel = (uint32_t*)hw_surface_get_buffer(surface);
         ei_size_t surface_size = hw_surface_get_size(surface);
 
-        // First line where intersect polygon, at first : the bottom of the surface
-        uint32_t y_first_line = surface_size.height;
+        // The drawing is restricted to the part of the clipper which is in the surface
+        ei_rect_t draw_rect = hw_surface_get_rect(surface);
+        if (clipper) {
+                draw_rect = ei_rect_intersection(draw_rect, *clipper);
+        }
+        if (ei_rect_is_empty(draw_rect)) {
+                hw_surface_unlock(surface);
+                return;
+        }
+        int32_t x_clip_min = draw_rect.top_left.x;
+        int32_t x_clip_max = draw_rect.top_left.x + draw_rect.size.width;
+        int32_t y_clip_min = draw_rect.top_left.y;
+        int32_t y_clip_max = draw_rect.top_left.y + draw_rect.size.height;
+
+        // Find the vertical extent of the polygon
+        int32_t y_min = points[0].y;
+        int32_t y_max = points[0].y;
+        for (uint32_t i = 1 ; i < nb_points ; ++i) {
+                y_min = points[i].y < y_min ? points[i].y : y_min;
+                y_max = points[i].y > y_max ? points[i].y : y_max;
+        }
 
-        // Init TC
-        uint32_t size_tab = surface_size.height;
-        side **tc = calloc(size_tab, sizeof(side));
-        for (uint32_t i = 0 ; i < size_tab ; ++i) {
-                tc[i] = NULL;
+        // Only the scanlines of the polygon which are in the clipper are drawn
+        int32_t y_first_line = y_min > y_clip_min ? y_min : y_clip_min;
+        int32_t y_last_line = y_max < y_clip_max ? y_max : y_clip_max;
+        if (y_first_line >= y_last_line) {
+                hw_surface_unlock(surface);
+                return;
         }
 
-        // Fill TC
-        while (first_point->next != NULL) {
-                ei_point_t p1 = first_point->point;
-                ei_point_t p2 = first_point->next->point;
+        // Init TC with one bucket per drawn scanline, sides are taken in the pool of the shared context
+        ei_raster_ctx *ctx = raster_ctx_get();
+        raster_ctx_reset(ctx, nb_points, y_last_line - y_first_line);
+        side **tc = ctx->tc;
 
-                // Skip when horizontal side
-                if (p1.y == p2.y) {
-                        first_point = first_point->next;
-                        continue;
-                }
+        // Fill TC. The last point is implicitly linked to the first one.
+        for (uint32_t i = 0 ; i < nb_points ; ++i) {
+                ei_point_t p1 = points[i];
+                ei_point_t p2 = i + 1 < nb_points ? points[i + 1] : points[0];
 
-                // Allocate memory to store a new side structure and fill it
-                side *new_side = malloc(sizeof(side));
-                new_side->next = NULL;
-                uint32_t indice_tc;
+                // Skip when horizontal side
+                if (p1.y == p2.y) continue;
 
+                // p1 is the top of the side
                 if (p1.y > p2.y) {
-                        new_side->ymax = p1.y;
-                        new_side->xymin = p2.x;
-                        new_side->dx = p1.x - p2.x;
-                        new_side->dy = p1.y - p2.y;
-                        indice_tc = p2.y;
-                } else {
-                        new_side->ymax = p2.y;
-                        new_side->xymin = p1.x;
-                        new_side->dx = p2.x - p1.x;
-                        new_side->dy = p2.y - p1.y;
-                        indice_tc = p1.y;
-
-                        // Update of the first and last lines of intersect
-                        y_first_line = p1.y < y_first_line ? p1.y : y_first_line;
+                        ei_point_t tmp = p1;
+                        p1 = p2;
+                        p2 = tmp;
                 }
-                new_side->error = 0;
-                new_side->inv_slope = ceil((double_t)new_side->dx/ new_side->dy);
-
-                // Insert the new side in tail of linked-list at indice_tc of TC
-                insert(&tc[indice_tc], new_side);
 
-                first_point = first_point->next;
+                // Skip sides which are entirely above or below the clipper
+                if (p2.y <= y_first_line || p1.y >= y_last_line) continue;
+
+                // Fill a new side structure
+                side *new_side = raster_ctx_new_side(ctx);
+                new_side->ymax = p2.y;
+                new_side->dx = p2.x - p1.x;
+                new_side->dy = p2.y - p1.y;
+                new_side->x_step = floor_div(new_side->dx, new_side->dy);
+                new_side->error_step = new_side->dx - new_side->x_step * new_side->dy;
+
+                // A side which begins above the clipper starts directly on its first scanline
+                int32_t y_start = p1.y < y_first_line ? y_first_line : p1.y;
+                int64_t x_move = (int64_t) new_side->dx * (y_start - p1.y);
+                int64_t x_offset = floor_div64(x_move, new_side->dy);
+                new_side->xymin = p1.x + (int32_t) x_offset;
+                new_side->error = (int32_t) (x_move - x_offset * new_side->dy);
+
+                // Insert the new side in the sorted linked-list of its first scanline
+                insert_sorted(&tc[y_start - y_first_line], new_side);
         }
 
         // Init TCA
@@ -421,54 +399,24 @@ void			ei_draw_polygon		(ei_surface_t			surface,
         uint32_t color_int = ei_map_rgba(surface, color);
 
         //Algorithm
-        uint32_t index_list = 0;
-        do {
-                // Copy linked list tc[y] into tca
-                move(&tc[y_first_line], &tca);
-
+        for (int32_t y = y_first_line ; y < y_last_line ; ++y) {
                 // Delete side of tca where ymax = y
-                delete(&tca, y_first_line);
-
-                // Sort tca by attribute xymin
-                insertion_sort(&tca);
-
-                // Change pixels color to fill polygon
-
-                // Get the first pixel which needs to be colored on the x-axis
-                int32_t begin_fill = get_xymin(tca, index_list);
-                ++index_list;
-                while(begin_fill != -1) {
-                        // Get the last pixel which needs to be colored on the x-axis
-                        int32_t end_fill = get_xymin(tca, index_list);
-                        ++index_list;
-
-                        // If the end of fill is -1, that is mean it will be fill by the color to the edge
-                        end_fill = end_fill != -1 ? end_fill : surface_size.width;
-
-                        // Color all the concerned pixels
-                        for (int32_t i = begin_fill ; i < end_fill ; ++i) {
-                                uint32_t pixel_index = i + y_first_line * surface_size.width;
-                                if (is_in_clipper(i, y_first_line, clipper)) {
-                                        first_pixel[pixel_index] = color_int;
-                                }
-                        }
+                delete(&tca, y);
 
-                        // Update the next first pixel which needs to be colored on the x-axis
-                        begin_fill = get_xymin(tca, index_list);
-                        ++index_list;
-                }
+                // Merge linked list tc[y] into tca, which stays sorted by attribute xymin
+                merge(&tc[y - y_first_line], &tca);
 
-                // Change scanline
-                ++y_first_line;
+                // Fill each span between two intersections, only the part of the span which is in the clipper
+                uint32_t *line = first_pixel + y * surface_size.width;
+                for (side *begin_side = tca ; begin_side != NULL && begin_side->next != NULL ; begin_side = begin_side->next->next) {
+                        int32_t begin_fill = begin_side->xymin > x_clip_min ? begin_side->xymin : x_clip_min;
+                        int32_t end_fill = begin_side->next->xymin < x_clip_max ? begin_side->next->xymin : x_clip_max;
+                        fill_span(line + begin_fill, color_int, end_fill - begin_fill);
+                }
 
                 // Update xymin for all nodes in tca
                 set_xymin(&tca);
-                index_list = 0;
-        } while (tca != NULL || !is_empty(tc, size_tab));
-
-        // Free memory
-        free(tc);
-        free(tca);
+        }
 
         hw_surface_unlock(surface);
 }
@@ -488,45 +436,55 @@ void			ei_draw_polygon		(ei_surface_t			surface,
  */
 void ei_draw_text (ei_surface_t surface, const ei_point_t* where, const char* text, ei_font_t font,
                    ei_color_t color, const ei_rect_t* clipper) {
-
-        // Lock the surface
-        hw_surface_lock(surface);
-
-        // Parameters of the rectangle where the copy will be done
-        ei_size_t *destination_size = malloc(sizeof(ei_size_t));
-        hw_text_compute_size(text, font, &(destination_size->width), &(destination_size->height));
-        ei_rect_t destination_rect = {*where, *destination_size};
-
-        // Surface which is copied
+        // Surface which is copied, it is rendered only if it is not in the cache
         if (font == NULL) font = ei_default_font;
-        ei_surface_t text_surface = hw_text_create_surface(text, font, color);
+        ei_surface_t text_surface = text_cache_get(text, font, color);
 
-        // Get the rectangle which contained text
+        // Rectangle where the whole text would be displayed
         ei_rect_t rect_text = hw_surface_get_rect(text_surface);
+        ei_rect_t destination_rect = ei_rect(*where, rect_text.size);
 
-        // Change sizes of rectangles which contained text (source and destination) if they are greater than the clipper
-        if (clipper->size.width < rect_text.size.width) {
-                rect_text.size.width = clipper->size.width;
-                destination_rect.size.width = clipper->size.width;
-        }
-        if (clipper->size.height < rect_text.size.height) {
-                rect_text.size.height = clipper->size.height;
-                destination_rect.size.height = clipper->size.height;
+        // Only the part of the text which is in the surface and in the clipper is copied
+        destination_rect = ei_rect_intersection(destination_rect, hw_surface_get_rect(surface));
+        if (clipper) {
+                destination_rect = ei_rect_intersection(destination_rect, *clipper);
         }
 
-        // Lock before use this surface into ei_copy_surface
-        hw_surface_lock(text_surface);
+        if (!ei_rect_is_empty(destination_rect)) {
+                // The source rectangle is the same part, expressed in the text surface
+                rect_text.top_left.x += destination_rect.top_left.x - where->x;
+                rect_text.top_left.y += destination_rect.top_left.y - where->y;
+                rect_text.size = destination_rect.size;
 
-        // Copy of the text
-        ei_copy_surface(surface, &destination_rect, text_surface, &rect_text, EI_TRUE);
+                // Lock before use surfaces into ei_copy_surface
+                hw_surface_lock(surface);
+                hw_surface_lock(text_surface);
 
-        // Free memory
-        free(destination_size);
+                // Copy of the text
+                ei_copy_surface(surface, &destination_rect, text_surface, &rect_text, EI_TRUE);
 
-        // Free memory for text surface and unlock the origin surface
-        hw_surface_unlock(text_surface);
-        hw_surface_free(text_surface);
-        hw_surface_unlock(surface);
+                hw_surface_unlock(text_surface);
+                hw_surface_unlock(surface);
+        }
+}
+
+/**
+ * @brief       Fill the part of a rectangle which is in the surface, line by line.
+ *
+ * @param       first_pixel     The pixel (0, 0) of the surface
+ * @param       surface_rect    The rectangle of the surface, its origin may not be (0, 0)
+ * @param       color           The color, already mapped with ei_map_rgba
+ * @param       rect            The rectangle to fill
+ */
+static void fill_rect(uint32_t *first_pixel, ei_rect_t surface_rect, uint32_t color, ei_rect_t rect) {
+        rect = ei_rect_intersection(rect, surface_rect);
+        if (ei_rect_is_empty(rect)) return;
+
+        uint32_t *line = first_pixel + rect.top_left.y * surface_rect.size.width + rect.top_left.x;
+        for (int y = 0; y < rect.size.height; y++){
+                fill_span(line, color, rect.size.width);
+                line += surface_rect.size.width;
+        }
 }
 
 /**
@@ -544,19 +502,41 @@ void			ei_fill			(ei_surface_t		surface,
         // Get all parameters
         hw_surface_lock(surface);
         uint32_t *first_pixel = (uint32_t*)hw_surface_get_buffer(surface);
-        ei_size_t size = hw_surface_get_size(surface);
-        uint32_t color_int = ei_map_rgba(surface, *color);
+        ei_rect_t surface_rect = hw_surface_get_rect(surface);
+        uint32_t color_int = ei_map_rgba(surface, color ? *color : (ei_color_t) {0x00, 0x00, 0x00, 0xff});
 
         // Put color on each pixels of the surface which are in the clipper
-        for (int y = 0; y < size.height; y++){
-                for(int x=0; x < size.width; x++){
-                        if (is_in_clipper(x, y, clipper)) {
-                                *first_pixel++ = color_int;
-                        } else {
-                                first_pixel++;
-                        }
-                }
+        fill_rect(first_pixel, surface_rect, color_int, clipper ? *clipper : surface_rect);
+
+        hw_surface_unlock(surface);
+}
+
+/**
+ * \brief	Fills several rectangles of the surface with the specified color.
+ *		The surface is locked only once for all the rectangles.
+ *
+ * @param	surface		The surface to be filled. The surface must be *locked* by
+ *				\ref hw_surface_lock.
+ * @param	color		The color used to fill the rectangles. If NULL, it means that the
+ *				caller want it painted black (opaque).
+ * @param	rects		The head of a linked list of the rectangles to fill. It can be NULL
+ *				(i.e. fills nothing).
+ */
+void			ei_fill_rects		(ei_surface_t			surface,
+                                                            const ei_color_t*		color,
+                                                            const ei_linked_rect_t*	rects) {
+        if (rects == NULL) return;
+
+        // Get all parameters
+        hw_surface_lock(surface);
+        uint32_t *first_pixel = (uint32_t*)hw_surface_get_buffer(surface);
+        ei_rect_t surface_rect = hw_surface_get_rect(surface);
+        uint32_t color_int = ei_map_rgba(surface, color ? *color : (ei_color_t) {0x00, 0x00, 0x00, 0xff});
+
+        for ( ; rects != NULL ; rects = rects->next) {
+                fill_rect(first_pixel, surface_rect, color_int, rects->rect);
         }
+
         hw_surface_unlock(surface);
 }
 
@@ -599,7 +579,7 @@ int	ei_copy_surface	(ei_surface_t destination, const ei_rect_t* dst_rect, ei_sur
 
         if (src_rect){
                 src_size_rect = src_rect->size;
-                src_pixel += (src_rect->top_left.y * src_size_surface.width + src_rect->top_left.x - 1) * 4;
+                src_pixel += (src_rect->top_left.y * src_size_surface.width + src_rect->top_left.x) * 4;
                 sum_src_next_line = 4 * (src_size_surface.width - src_size_rect.width);
         } else {
                 src_size_rect = src_size_surface;
@@ -615,7 +595,7 @@ int	ei_copy_surface	(ei_surface_t destination, const ei_rect_t* dst_rect, ei_sur
 
         if (dst_rect){
                 dst_size_rect = dst_rect->size;
-                dst_pixel += (dst_rect->top_left.y * dst_size_surface.width + dst_rect->top_left.x - 1) * 4;
+                dst_pixel += (dst_rect->top_left.y * dst_size_surface.width + dst_rect->top_left.x) * 4;
                 sum_dst_next_line = 4 * (dst_size_surface.width - dst_size_rect.width);
         } else {
                 dst_size_rect = dst_size_surface;
@@ -629,35 +609,19 @@ int	ei_copy_surface	(ei_surface_t destination, const ei_rect_t* dst_rect, ei_sur
                 return 1;
         }
 
-        // If alpha is true, makes a combination of source and destination pixels weighted by the source alpha channel
-        if (alpha == EI_TRUE){
-                for (uint32_t y = 0; y < src_size_rect.height; y++){
-                        for (uint32_t x = 0; x < src_size_rect.width; x++){
-                                dst_pixel[red_place] = (dst_pixel[red_place] * (255 - src_pixel[alpha_place]) + src_pixel[red_place] * src_pixel[alpha_place]) / 255;
-                                dst_pixel[blue_place] = (dst_pixel[blue_place] * (255 - src_pixel[alpha_place]) + src_pixel[blue_place] * src_pixel[alpha_place]) / 255;
-                                dst_pixel[green_place] = (dst_pixel[green_place] * (255 - src_pixel[alpha_place]) + src_pixel[green_place] * src_pixel[alpha_place]) / 255;
-                                dst_pixel[alpha_place] = 255;
-                                src_pixel += 4;
-                                dst_pixel += 4;
-                        }
-                        dst_pixel += sum_dst_next_line;
-                        src_pixel += sum_src_next_line;
-                }
+        // Size of a line of each rectangle, in bytes
+        size_t line_size = 4 * src_size_rect.width;
 
-        // If alpha is false, the final pixels are an exact copy of the source pixels
-        } else {
-                for (uint32_t y = 0; y < src_size_rect.height; y++){
-                        for (uint32_t x = 0; x < src_size_rect.width; x++){
-                                dst_pixel[red_place] = src_pixel[red_place];
-                                dst_pixel[green_place] = src_pixel[green_place];
-                                dst_pixel[blue_place] = src_pixel[blue_place];
-                                dst_pixel[alpha_place] = src_pixel[alpha_place];
-                                src_pixel += 4;
-                                dst_pixel += 4;
-                        }
-                        dst_pixel += sum_dst_next_line;
-                        src_pixel += sum_src_next_line;
+        for (uint32_t y = 0; y < src_size_rect.height; y++){
+                if (alpha == EI_TRUE){
+                        // Makes a combination of source and destination pixels weighted by the source alpha channel
+                        blend_span((uint32_t *) dst_pixel, (const uint32_t *) src_pixel, src_size_rect.width, alpha_place);
+                } else {
+                        // The final pixels are an exact copy of the source pixels
+                        memcpy(dst_pixel, src_pixel, line_size);
                 }
+                dst_pixel += line_size + sum_dst_next_line;
+                src_pixel += line_size + sum_src_next_line;
         }
 
         // Doesn't forget to unlock surface
@@ -666,13 +630,101 @@ int	ei_copy_surface	(ei_surface_t destination, const ei_rect_t* dst_rect, ei_sur
         return 0;
 }
 
+/**
+ * \brief	Copies pixels inside a surface, from a rectangle to another one of the same size.
+ *		Unlike \ref ei_copy_surface, the two rectangles may overlap: the result is the same
+ *		as if the source pixels were saved before being copied. Used to move a part of the
+ *		window without drawing it again.
+ *		The surface must be *locked* by \ref hw_surface_lock.
+ *
+ * @param	surface		The surface in which to copy pixels.
+ * @param	dst_rect	The rectangle on the surface where to copy the pixels.
+ * @param	src_rect	The rectangle on the surface from which to copy the pixels.
+ *
+ * @return			Returns 0 on success, 1 on failure (different sizes between the rectangles,
+ *				or a rectangle which is not inside the surface).
+ */
+int	ei_copy_surface_overlap	(ei_surface_t surface, const ei_rect_t* dst_rect, const ei_rect_t* src_rect){
+        ei_size_t size_surface = hw_surface_get_size(surface);
+        ei_size_t size_rect = src_rect->size;
+
+        // Verifies if different sizes
+        if (dst_rect->size.width != size_rect.width || dst_rect->size.height != size_rect.height){
+                return 1;
+        }
+
+        // Verifies if both rectangles are inside the surface
+        const ei_rect_t *rects[2] = {dst_rect, src_rect};
+        for (int i = 0; i < 2; i++){
+                if (rects[i]->top_left.x < 0 || rects[i]->top_left.y < 0
+                    || rects[i]->top_left.x + size_rect.width > size_surface.width
+                    || rects[i]->top_left.y + size_rect.height > size_surface.height){
+                        return 1;
+                }
+        }
+
+        hw_surface_lock(surface);
+        uint8_t *buffer = hw_surface_get_buffer(surface);
+        uint8_t *src_pixel = buffer + (src_rect->top_left.y * size_surface.width + src_rect->top_left.x) * 4;
+        uint8_t *dst_pixel = buffer + (dst_rect->top_left.y * size_surface.width + dst_rect->top_left.x) * 4;
+
+        // Size of a line of the rectangles, and offset to the next line to copy, in bytes
+        size_t line_size = 4 * size_rect.width;
+        ptrdiff_t next_line = 4 * size_surface.width;
+
+        // If the destination is lower, the lines are copied from the bottom, so that a source line is
+        // copied before it is overwritten. Inside a line, memmove handles the overlap.
+        if (dst_rect->top_left.y > src_rect->top_left.y && size_rect.height > 0){
+                src_pixel += (size_rect.height - 1) * next_line;
+                dst_pixel += (size_rect.height - 1) * next_line;
+                next_line = -next_line;
+        }
+
+        for (int y = 0; y < size_rect.height; y++){
+                memmove(dst_pixel, src_pixel, line_size);
+                dst_pixel += next_line;
+                src_pixel += next_line;
+        }
+
+        hw_surface_unlock(surface);
+        return 0;
+}
+
+/**
+ * @brief       Draw the image of a widget. The image is placed in the content_rect depending on the anchor,
+ *              and only the part of the image which is in the clipper is copied.
+ *
+ * @param       surface         Where to draw the image.
+ * @param       img             The image surface.
+ * @param       img_rect        The subpart of img to display. If NULL, the whole image is used.
+ * @param       img_anchor      The anchor of the image in the content_rect.
+ * @param       content_rect    The content_rect of the widget.
+ * @param       clipper         The visible part of the content_rect.
+ */
+static void draw_image(ei_surface_t surface, ei_surface_t img, ei_rect_t *img_rect, ei_anchor_t *img_anchor,
+                       ei_rect_t *content_rect, ei_rect_t *clipper) {
+        ei_rect_t source_rect = img_rect ? *img_rect : hw_surface_get_rect(img);
+        ei_point_t img_coord = text_place(img_anchor, &source_rect.size, &content_rect->top_left, &content_rect->size);
+
+        // Only the part of the image which is visible is copied
+        ei_rect_t destination_rect = ei_rect_intersection(ei_rect(img_coord, source_rect.size), *clipper);
+        if (!ei_rect_is_empty(destination_rect)) {
+                source_rect.top_left.x += destination_rect.top_left.x - img_coord.x;
+                source_rect.top_left.y += destination_rect.top_left.y - img_coord.y;
+                source_rect.size = destination_rect.size;
+
+                ei_copy_surface(surface, &destination_rect, img, &source_rect, EI_TRUE);
+        }
+}
+
 /**
  * \brief	A function that draws widgets of button class.
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -682,7 +734,7 @@ void                    ei_draw_button          (ei_widget_t*	        widget,
                                                  ei_rect_t*		clipper) {
         // Init
         ei_button_t *button = (ei_button_t*) widget;
-        clipper_content_rect(widget, clipper);
+        ei_rect_t visible_content_rect = clipper_content_rect(widget, clipper);
 
         // Get size and place parameters
         int width_button = button->widget.screen_location.size.width;
@@ -696,6 +748,16 @@ void                    ei_draw_button          (ei_widget_t*	        widget,
         ei_point_t place_middle_button = {place_x + (button->border_width), place_y + (button->border_width)};
         ei_rect_t middle_rect = ei_rect(place_middle_button, size_middle_button);
 
+        // Get all points for center part of button, it is also the part of the button in the offscreen
+        ei_point_t pts_middle[ROUNDED_FRAME_MAX_POINTS];
+        uint32_t nb_pts_middle = rounded_frame_cached(middle_rect, button->corner_radius, FULL, pts_middle);
+
+        // Draw in offscreen
+        if (pick_surface) {
+                ei_draw_polygon_n(pick_surface, pts_middle, nb_pts_middle, *button->widget.pick_color, clipper);
+        }
+        if (surface == NULL) return;
+
         // Color of center part
         ei_color_t base_color = button->color;
 
@@ -748,79 +810,45 @@ void                    ei_draw_button          (ei_widget_t*	        widget,
                 }
 
                 // Get all points for border button modelization
-                ei_linked_point_t *pts_top = rounded_frame(border_rect, button->corner_radius, TOP);
-                ei_linked_point_t *pts_bottom = rounded_frame(border_rect, button->corner_radius, BOTTOM);
+                ei_point_t pts_top[ROUNDED_FRAME_MAX_POINTS];
+                ei_point_t pts_bottom[ROUNDED_FRAME_MAX_POINTS];
+                uint32_t nb_pts_top = rounded_frame_cached(border_rect, button->corner_radius, TOP, pts_top);
+                uint32_t nb_pts_bottom = rounded_frame_cached(border_rect, button->corner_radius, BOTTOM, pts_bottom);
 
                 // Display border button
-                ei_draw_polygon(surface, pts_top, color_top, clipper);
-                ei_draw_polygon(surface, pts_bottom, color_bottom, clipper);
-
-                // Free memory
-                free_list(pts_top);
-                free_list(pts_bottom);
+                ei_draw_polygon_n(surface, pts_top, nb_pts_top, color_top, clipper);
+                ei_draw_polygon_n(surface, pts_bottom, nb_pts_bottom, color_bottom, clipper);
         }
 
-        // Get all points for center part of button
-        ei_linked_point_t *pts_middle = rounded_frame(middle_rect, button->corner_radius, FULL);
-
         // Draw the center part of the button (without border)
-        ei_draw_polygon(surface, pts_middle, base_color, clipper);
-
-        // Draw in offscreen
-        if (pick_surface) {
-                ei_draw_polygon(pick_surface, pts_middle, *button->widget.pick_color, clipper);
-        }
-
-        // Free memory
-        free_list(pts_middle);
+        ei_draw_polygon_n(surface, pts_middle, nb_pts_middle, base_color, clipper);
 
         // Image treatment only if there is an image to display
         if (button->img) {
-                ei_point_t *img_coord = text_place(&button->img_anchor, &button->img_rect->size,
-                                                   &button->widget.content_rect->top_left,
-                                                   &button->widget.content_rect->size);
-
-                // Change size of rectangle which contained image (source only) if it is greater than the content_rect
-                if (button->widget.content_rect->size.width < button->img_rect->size.width) {
-                        button->img_rect->size.width = button->widget.content_rect->size.width;
-                }
-                if (button->widget.content_rect->size.height < button->img_rect->size.height) {
-                        button->img_rect->size.height = button->widget.content_rect->size.height;
-                }
-
-                ei_rect_t img_dest_rect = ei_rect(*img_coord, button->widget.content_rect->size);
-
-                ei_copy_surface(surface, &img_dest_rect, button->img, button->img_rect, EI_TRUE);
-
-                // Free memory
-                free(img_coord);
+                draw_image(surface, button->img, button->img_rect, &button->img_anchor, button->widget.content_rect, &visible_content_rect);
         }
 
         // Text treatment only if there is a text to display
         if (button->text) {
                 // Configure text place
-                ei_size_t *text_size = calloc(1, sizeof(ei_size_t));
-                hw_text_compute_size(button->text, button->text_font, &(text_size->width), &(text_size->height));
+                ei_size_t text_size;
+                text_cache_compute_size(button->text, button->text_font, &text_size.width, &text_size.height);
 
                 // Change values of text_size if this one is greater than the parent
-                if (button->widget.content_rect->size.width <= text_size->width) {
-                        text_size->width = button->widget.content_rect->size.width;
+                if (button->widget.content_rect->size.width <= text_size.width) {
+                        text_size.width = button->widget.content_rect->size.width;
                 }
-                if (button->widget.content_rect->size.height <= text_size->height) {
-                        text_size->height = button->widget.content_rect->size.height;
+                if (button->widget.content_rect->size.height <= text_size.height) {
+                        text_size.height = button->widget.content_rect->size.height;
                 }
 
                 // Get top-left corner of the text
-                ei_point_t *text_coord = text_place(&button->text_anchor, text_size,
+                ei_point_t text_coord = text_place(&button->text_anchor, &text_size,
                                                     &button->widget.content_rect->top_left,
                                                     &button->widget.content_rect->size);
 
                 // Display text
-                ei_draw_text(surface, text_coord, button->text, button->text_font, button->text_color, button->widget.content_rect);
-
-                // Free memory
-                free(text_size);
-                free(text_coord);
+                ei_draw_text(surface, &text_coord, button->text, button->text_font, button->text_color, &visible_content_rect);
         }
 }
 
@@ -829,8 +857,9 @@ void                    ei_draw_button          (ei_widget_t*	        widget,
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -840,7 +869,7 @@ void ei_draw_frame (ei_widget_t*        widget,
                     ei_rect_t*		clipper) {
         // Init
         ei_frame_t *frame = (ei_frame_t*) widget;
-        clipper_content_rect(widget, clipper);
+        ei_rect_t visible_content_rect = clipper_content_rect(widget, clipper);
 
         // Get size and place parameters
         int width_frame = frame->widget.screen_location.size.width;
@@ -854,6 +883,16 @@ void ei_draw_frame (ei_widget_t*        widget,
         ei_point_t place_middle_frame = {place_x + (frame->border_width), place_y + (frame->border_width)};
         ei_rect_t middle_rect = ei_rect(place_middle_frame, size_middle_frame);
 
+        // The center part of the frame is also its part in the offscreen
+        ei_point_t pts_frame[5];
+        rectangle_points(middle_rect, pts_frame);
+
+        // Display in offscreen
+        if (pick_surface) {
+                ei_draw_polygon_n(pick_surface, pts_frame, 5, *frame->widget.pick_color, clipper);
+        }
+        if (surface == NULL) return;
+
         if (frame->border_width != 0) {
                 // In this case, it needs to create a border with relief
 
@@ -903,74 +942,44 @@ void ei_draw_frame (ei_widget_t*        widget,
                 }
 
                 // Get all points for border frame modelization
-                ei_linked_point_t *pts_top = rounded_frame(border_rect, 0, TOP);
-                ei_linked_point_t *pts_bottom = rounded_frame(border_rect, 0, BOTTOM);
+                ei_point_t pts_top[ROUNDED_FRAME_MAX_POINTS];
+                ei_point_t pts_bottom[ROUNDED_FRAME_MAX_POINTS];
+                uint32_t nb_pts_top = rounded_frame_cached(border_rect, 0, TOP, pts_top);
+                uint32_t nb_pts_bottom = rounded_frame_cached(border_rect, 0, BOTTOM, pts_bottom);
 
                 // Display border frame
-                ei_draw_polygon(surface, pts_top, color_top, clipper);
-                ei_draw_polygon(surface, pts_bottom, color_bottom, clipper);
-
-                // Free memory
-                free_list(pts_top);
-                free_list(pts_bottom);
+                ei_draw_polygon_n(surface, pts_top, nb_pts_top, color_top, clipper);
+                ei_draw_polygon_n(surface, pts_bottom, nb_pts_bottom, color_bottom, clipper);
         }
 
-        ei_linked_point_t *pts_frame = get_rectangle_list(middle_rect);
-        ei_draw_polygon(surface, pts_frame, frame->color, clipper);
-
-        // Display in offscreen
-        ei_draw_polygon(pick_surface, pts_frame, *frame->widget.pick_color, clipper);
-
-        // Free memory
-        free_list(pts_frame);
+        ei_draw_polygon_n(surface, pts_frame, 5, frame->color, clipper);
 
         // Frame treatment only if there is a frame to display
         if (frame->img) {
-                ei_point_t *img_coord = text_place(&frame->img_anchor, &frame->img_rect->size,
-                                                   &frame->widget.content_rect->top_left,
-                                                   &frame->widget.content_rect->size);
-
-                // Change size of rectangle which contained image (source only) if it is greater than the content_rect
-                if (frame->widget.content_rect->size.width < frame->img_rect->size.width) {
-                        frame->img_rect->size.width = frame->widget.content_rect->size.width;
-                }
-                if (frame->widget.content_rect->size.height < frame->img_rect->size.height) {
-                        frame->img_rect->size.height = frame->widget.content_rect->size.height;
-                }
-
-                ei_rect_t img_dest_rect = ei_rect(*img_coord, frame->widget.content_rect->size);
-
-                ei_copy_surface(surface, &img_dest_rect, frame->img, frame->img_rect, EI_TRUE);
-
-                // Free memory
-                free(img_coord);
+                draw_image(surface, frame->img, frame->img_rect, &frame->img_anchor, frame->widget.content_rect, &visible_content_rect);
         }
 
         // Text treatment only if there is a text to display
         if (frame->text) {
                 // Configure text place
-                ei_size_t *text_size = calloc(1, sizeof(ei_size_t));
-                hw_text_compute_size(frame->text, frame->text_font, &(text_size->width), &(text_size->height));
+                ei_size_t text_size;
+                text_cache_compute_size(frame->text, frame->text_font, &text_size.width, &text_size.height);
 
                 // Change values of text_size if this one is greater than the parent
-                if (frame->widget.content_rect->size.width <= text_size->width) {
-                        text_size->width = frame->widget.content_rect->size.width;
+                if (frame->widget.content_rect->size.width <= text_size.width) {
+                        text_size.width = frame->widget.content_rect->size.width;
                 }
-                if (frame->widget.content_rect->size.height <= text_size->height) {
-                        text_size->height = frame->widget.content_rect->size.height;
+                if (frame->widget.content_rect->size.height <= text_size.height) {
+                        text_size.height = frame->widget.content_rect->size.height;
                 }
 
                 // Get top-left corner of the text
-                ei_point_t *text_coord = text_place(&frame->text_anchor, text_size,
+                ei_point_t text_coord = text_place(&frame->text_anchor, &text_size,
                                                     &frame->widget.content_rect->top_left,
                                                     &frame->widget.content_rect->size);
 
                 // Display text
-                ei_draw_text(surface, text_coord, frame->text, frame->text_font, frame->text_color, frame->widget.content_rect);
-
-                // Free memory
-                free(text_size);
-                free(text_coord);
+                ei_draw_text(surface, &text_coord, frame->text, frame->text_font, frame->text_color, &visible_content_rect);
         }
 }
 
@@ -979,8 +988,9 @@ void ei_draw_frame (ei_widget_t*        widget,
  *
  * @param	widget		A pointer to the widget instance to draw.
  * @param	surface		Where to draw the widget. The actual location of the widget in the
- *				surface is stored in its "screen_location" field.
- * @param	pick_surface	The picking offscreen.
+ *				surface is stored in its "screen_location" field. If NULL, only the
+ *				picking offscreen is drawn.
+ * @param	pick_surface	The picking offscreen. If NULL, it is not drawn.
  * @param	clipper		If not NULL, the drawing is restricted within this rectangle
  *				(expressed in the surface reference frame).
  */
@@ -990,12 +1000,21 @@ void ei_draw_top_level (ei_widget_t*            widget,
                         ei_rect_t*		clipper) {
         // Init
         ei_top_level_t *top_level = (ei_top_level_t *) widget;
-        clipper_content_rect(widget, clipper);
         ei_color_t border_color = {0x00, 0x00, 0x00, 0xff};
 
+        // Get all points for border toplevel modelization
+        ei_point_t pts_border[5];
+        rectangle_points(top_level->widget.screen_location, pts_border);
+
+        // Display in offscreen
+        if (pick_surface) {
+                ei_draw_polygon_n(pick_surface, pts_border, 5, *top_level->widget.pick_color, clipper);
+        }
+        if (surface == NULL) return;
+
         // Configure text place
-        ei_size_t *text_size = calloc(1, sizeof(ei_size_t));
-        hw_text_compute_size(top_level->title, ei_default_font, &(text_size->width), &(text_size->height));
+        ei_size_t text_size;
+        text_cache_compute_size(top_level->title, ei_default_font, &text_size.width, &text_size.height);
 
         // Text place in top bar
         ei_anchor_t text_anchor = ei_anc_west;
@@ -1003,28 +1022,20 @@ void ei_draw_top_level (ei_widget_t*            widget,
         // Get x place param
         int place_x = top_level->widget.screen_location.top_left.x;
 
-        // Get all points for border toplevel modelization
-        ei_linked_point_t *pts_border = get_rectangle_list(top_level->widget.screen_location);
-
         // Display border toplevel
-        ei_draw_polygon(surface, pts_border, border_color, clipper);
-
-        // Display in offscreen
-        ei_draw_polygon(pick_surface, pts_border, *top_level->widget.pick_color, clipper);
-
-        // Free memory
-        free_list(pts_border);
+        ei_draw_polygon_n(surface, pts_border, 5, border_color, clipper);
 
         // Draw content rect part of top level
-        ei_linked_point_t *pts_content_rect = get_rectangle_list(*top_level->widget.content_rect);
-        ei_draw_polygon(surface, pts_content_rect, top_level->color, clipper);
+        ei_point_t pts_content_rect[5];
+        rectangle_points(*top_level->widget.content_rect, pts_content_rect);
+        ei_draw_polygon_n(surface, pts_content_rect, 5, top_level->color, clipper);
 
         // Change values of text_size if this one is greater than the parent
-        if (top_level->widget.content_rect->size.width <= text_size->width) {
-                text_size->width = top_level->top_bar->size.width;
+        if (top_level->widget.content_rect->size.width <= text_size.width) {
+                text_size.width = top_level->top_bar->size.width;
         }
-        if (top_level->widget.content_rect->size.height <= text_size->height) {
-                text_size->height = top_level->top_bar->size.height;
+        if (top_level->widget.content_rect->size.height <= text_size.height) {
+                text_size.height = top_level->top_bar->size.height;
         }
 
         // Text clipper
@@ -1034,8 +1045,9 @@ void ei_draw_top_level (ei_widget_t*            widget,
         ei_point_t place_text = top_level->widget.screen_location.top_left;
 
         if (top_level->closable) {
-                // Display button
-                ei_draw_button((ei_widget_t*) top_level->close_button, surface, NULL, top_level->top_bar);
+                // Display button, it is restricted within the visible part of the top bar
+                ei_rect_t button_clipper = clipper ? ei_rect_intersection(*top_level->top_bar, *clipper) : *top_level->top_bar;
+                ei_draw_button((ei_widget_t*) top_level->close_button, surface, NULL, &button_clipper);
 
                 // Change x-axis place including space used by close button
                 place_text.x += top_level->close_button->widget.screen_location.size.width + (top_level->close_button->widget.screen_location.top_left.x - place_x) + top_level->border_width;
@@ -1044,26 +1056,24 @@ void ei_draw_top_level (ei_widget_t*            widget,
                 text_clipper.size.width -= place_text.x - place_x + top_level->border_width;
         }
 
+        // Text is also restricted within the clipper
+        if (clipper) {
+                text_clipper = ei_rect_intersection(text_clipper, *clipper);
+        }
+
         // Get top-left corner of the text
-        ei_point_t *text_coord = text_place(&text_anchor, text_size, &place_text, &top_level->top_bar->size);
+        ei_point_t text_coord = text_place(&text_anchor, &text_size, &place_text, &top_level->top_bar->size);
 
         // Display title
-        ei_draw_text(surface, text_coord, top_level->title, ei_default_font, top_level->color, &text_clipper);
-
-        // Free memory
-        free_list(pts_content_rect);
-        free(text_coord);
-        free(text_size);
+        ei_draw_text(surface, &text_coord, top_level->title, ei_default_font, top_level->color, &text_clipper);
 
         if (top_level->resizable != ei_axis_none) {
                 // Get all points for rectangle used to resize
-                ei_linked_point_t *pts_rect_resize = get_rectangle_list(*top_level->resize_rect);
+                ei_point_t pts_rect_resize[5];
+                rectangle_points(*top_level->resize_rect, pts_rect_resize);
 
                 // Display rectangle used to resize
-                ei_draw_polygon(surface, pts_rect_resize, border_color, clipper);
-
-                // Free memory
-                free_list(pts_rect_resize);
+                ei_draw_polygon_n(surface, pts_rect_resize, 5, border_color, clipper);
         }
 }
 
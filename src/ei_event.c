@@ -1,5 +1,9 @@
 #include "ei_event.h"
+#include "ei_application.h"
 #include "event_manager.h"
+#include "render_cache.h"
+#include "class_registry.h"
+#include "ei_utils.h"
 
 /*
  * Intermediate functions, use by callback functions
@@ -26,30 +30,24 @@ static inline ei_bool_t is_rectangle_in_rectangle(ei_rect_t rectangle, ei_point_
 }
 
 /**
- * @param widget, the widget of which each child will be updated by @ref ei_placer_run function
+ * @brief Move a rectangle the least possible so that it is in another one. If it is larger than the other
+ *        rectangle, its top left corner is aligned on the one of the other rectangle.
  *
- * @return Nothing.
+ * @param rectangle, the rectangle in which the moved rectangle must be.
+ * @param t_point, the top left point of the moved rectangle.
+ * @param t_rect, the size of the moved rectangle.
+ *
+ * @return The top left point of the moved rectangle, once it is in rectangle.
  */
-void children_resizing(struct ei_widget_t* widget){
-
-        ei_widget_t * widget_to_change = widget;
-        // Depth course of each widgets. Resize each one in function of the parent.
-        do {
-                if (widget_to_change->children_head) {
-                        widget_to_change = widget_to_change->children_head;
-                        ei_placer_run(widget_to_change);
-                }
-                else {
-                        while (widget_to_change != widget && widget_to_change->next_sibling == NULL) {
-                                widget_to_change = widget_to_change->parent;
-                        }
-
-                        if (widget_to_change->next_sibling && widget_to_change != widget) {
-                                widget_to_change = widget_to_change->next_sibling;
-                                ei_placer_run(widget_to_change);
-                        }
-                }
-        } while (widget_to_change != widget);
+static inline ei_point_t clamp_in_rectangle(ei_rect_t rectangle, ei_point_t t_point, ei_size_t t_rect){
+        int x_max = rectangle.top_left.x + rectangle.size.width - t_rect.width;
+        int y_max = rectangle.top_left.y + rectangle.size.height - t_rect.height;
+
+        if (t_point.x > x_max) t_point.x = x_max;
+        if (t_point.y > y_max) t_point.y = y_max;
+        if (t_point.x < rectangle.top_left.x) t_point.x = rectangle.top_left.x;
+        if (t_point.y < rectangle.top_left.y) t_point.y = rectangle.top_left.y;
+        return t_point;
 }
 
 /**
@@ -63,25 +61,9 @@ static inline void replace_order(ei_widget_t* widget){
         // Replace each toplevel parent until to the root_frame
         while (widget != g_root_frame) {
                 // Put all (and just) the toplevel concerned to the front
-                if (strcmp(ei_widgetclass_stringname(widget->wclass->name), "toplevel") == 0) {
-                        // If the widget is not yet the last children, put it as
-                        if (widget != widget->parent->children_tail) {
-                                ei_widget_t *widget_to_change = widget->parent->children_head;
-                                if (widget_to_change == widget) {
-                                        widget->parent->children_head = widget->next_sibling;
-
-                                }
-                                else {
-                                        while (widget_to_change->next_sibling != widget) {
-                                                widget_to_change = widget_to_change->next_sibling;
-                                        }
-                                        widget_to_change->next_sibling = widget->next_sibling;
-                                }
-
-                                widget->parent->children_tail->next_sibling = widget;
-                                widget->parent->children_tail = widget;
-                                widget->next_sibling = NULL;
-                        }
+                if (widget->wclass->id == CLASS_ID_TOPLEVEL) {
+                        // Put it as the last children, it is now drawn over its siblings
+                        ei_widget_raise(widget);
                 }
                 widget = widget->parent;
         }
@@ -115,7 +97,7 @@ ei_bool_t keyword_event_callback(ei_event_t *event){
                         do {
                                 if (widget_to_treat->children_head) {
                                         widget_to_treat = widget_to_treat->children_head;
-                                        if (strcmp(ei_widgetclass_stringname(widget_to_treat->wclass->name),"toplevel")==0){
+                                        if (widget_to_treat->wclass->id == CLASS_ID_TOPLEVEL){
                                                 if (widget_to_destroy){
                                                         if (widget_to_treat->pick_id > widget_to_destroy->pick_id){
                                                                 widget_to_destroy = widget_to_treat;
@@ -234,13 +216,16 @@ ei_bool_t handle_top_level_function(struct ei_widget_t* widget,
                 } else if (event->type == ei_ev_mouse_move && ei_event_get_active_widget() == widget){
                         // Case of resizing
                         if (toplevel_widget->current_event == event_resize) {
+                                // The width and the height are placed together
+                                ei_layout_begin();
+
                                 int new_width =
                                         event->param.mouse.where.x - toplevel_widget->widget.content_rect->top_left.x;
                                 int new_height =
                                         event->param.mouse.where.y - toplevel_widget->widget.content_rect->top_left.y;
 
                                 // If the toplevel is in another toplevel
-                                if (strcmp(ei_widgetclass_stringname(toplevel_widget->widget.parent->wclass->name), "toplevel") == 0) {
+                                if (toplevel_widget->widget.parent->wclass->id == CLASS_ID_TOPLEVEL) {
                                         ei_size_t new_size = {new_width + toplevel_widget->border_width, new_height + toplevel_widget->top_bar->size.height};
                                         float new_rel_width = (float) new_width /
                                                               toplevel_widget->widget.parent->content_rect->size.width;
@@ -284,8 +269,7 @@ ei_bool_t handle_top_level_function(struct ei_widget_t* widget,
                                                          NULL);
                                         }
                                 }
-                                // Resize also the children of the removed widget
-                                children_resizing(widget);
+                                ei_layout_commit();
                         }
                                 // Case of moving
                         else if (toplevel_widget->current_event == event_move){
@@ -294,23 +278,20 @@ ei_bool_t handle_top_level_function(struct ei_widget_t* widget,
                                 int new_loc_y = toplevel_widget->widget.screen_location.top_left.y + event->param.mouse.where.y - g_previous_event->param.mouse.where.y;
                                 ei_point_t new_loc = {new_loc_x, new_loc_y};
 
-                                // Case of toplevel in another one
-                                if (strcmp(ei_widgetclass_stringname(toplevel_widget->widget.parent->wclass->name), "toplevel") == 0) {
-                                        // If the mouse is still in the parent limit, so the top level is moved to the new coord
-                                        if (is_rectangle_in_rectangle(*toplevel_widget->widget.parent->content_rect, new_loc, &toplevel_widget->widget.screen_location.size)) {
-                                                // The location is relative to the coord of the parent
-                                                new_loc_x -= toplevel_widget->widget.parent->content_rect->top_left.x;
-                                                new_loc_y -= toplevel_widget->widget.parent->content_rect->top_left.y;
-                                                ei_place(&toplevel_widget->widget, NULL, &new_loc_x, &new_loc_y, NULL, NULL, NULL, NULL, NULL, NULL);
-                                                children_resizing(widget);
-                                        }
+                                // The toplevel must rest in its parent if it is a toplevel, in the root frame otherwise
+                                ei_rect_t limits = g_root_frame->screen_location;
+                                ei_point_t origin = ei_point_zero();
+                                if (toplevel_widget->widget.parent->wclass->id == CLASS_ID_TOPLEVEL) {
+                                        limits = *toplevel_widget->widget.parent->content_rect;
+                                        // The location is relative to the coord of the parent
+                                        origin = limits.top_left;
                                 }
-                                        // If there isn't parent, so verifies that the top level is still in the root frame
-                                else {
-                                        if (is_rectangle_in_rectangle(g_root_frame->screen_location, new_loc, &toplevel_widget->widget.screen_location.size)){
-                                                ei_place(widget, NULL, &new_loc_x, &new_loc_y, NULL, NULL, NULL, NULL, NULL, NULL);
-                                                children_resizing(widget);
-                                        }
+
+                                // The toplevel stops against the limits, even when a fast move is treated at once
+                                new_loc = clamp_in_rectangle(limits, new_loc, toplevel_widget->widget.screen_location.size);
+                                if (new_loc.x != toplevel_widget->widget.screen_location.top_left.x
+                                    || new_loc.y != toplevel_widget->widget.screen_location.top_left.y) {
+                                        move_placed_widget(widget, new_loc.x - origin.x, new_loc.y - origin.y);
                                 }
                                 // The current event is saved as previous event for compute the next movement
                                 *g_previous_event = *event;
@@ -357,6 +338,8 @@ ei_bool_t handle_button_function(struct ei_widget_t* widget,
                 // If the left button of the mouse is down
                 if (event->type == ei_ev_mouse_buttondown) {
                         button_widget->relief = ei_relief_sunken;
+                        render_cache_invalidate(widget);
+                        ei_app_invalidate_rect(&widget->screen_location);
                         ei_event_set_active_widget(widget);
                         button_widget->callback(widget, event, button_widget->user_param);
                         return EI_TRUE;
@@ -365,6 +348,8 @@ ei_bool_t handle_button_function(struct ei_widget_t* widget,
                         // If the left button of the mouse is up
                 else if (event->type == ei_ev_mouse_buttonup) {
                         button_widget->relief = ei_relief_raised;
+                        render_cache_invalidate(widget);
+                        ei_app_invalidate_rect(&widget->screen_location);
                         ei_event_set_active_widget(NULL);
                         return EI_TRUE;
                 }
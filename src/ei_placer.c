@@ -1,5 +1,36 @@
 #include <ei_widget.h>
 #include "ei_placer.h"
+#include "ei_application.h"
+#include "application.h"
+#include "widget_manager.h"
+#include "render_cache.h"
+#include "pick_index.h"
+#include "class_registry.h"
+
+/**
+ * @brief       A widget waiting for the commit of a layout transaction.
+ */
+typedef struct layout_entry {
+        ei_widget_t*    widget;         ///< The widget, NULL if it has been forgotten meanwhile
+        uint32_t        depth;          ///< Number of ancestors of the widget, parents are placed before children
+} layout_entry;
+
+// Number of open layout transactions, the placements are queued while it is not 0
+static uint32_t g_layout_depth = 0;
+
+// Widgets to place at the commit of the outermost transaction
+static layout_entry *g_layout_queue = NULL;
+static uint32_t g_layout_queue_length = 0;
+static uint32_t g_layout_queue_size = 0;
+
+// Number of the current commit, a widget whose layout_stamp is equal has already been placed
+static uint32_t g_layout_stamp = 0;
+
+// A widget is moved with its pixels by move_placed_widget, the locations of its subtree are not drawn again
+static ei_bool_t g_is_moving_pixels = EI_FALSE;
+
+static void place_widget(struct ei_widget_t* widget);
+static void translate_children(struct ei_widget_t* widget, ei_rect_t old_content_rect, ei_point_t shift);
 
 /**
  * \brief	Configures the geometry of a widget using the "placer" geometry manager.
@@ -42,6 +73,10 @@ void		ei_place	(struct ei_widget_t*	widget,
                                      float*			rel_y,
                                      float*			rel_width,
                                      float*			rel_height){
+        // A placed widget whose position only is changed looks the same, see place_widget
+        ei_bool_t is_move = widget->placer_params != NULL && (anchor || x || y || rel_x || rel_y)
+                            && !width && !height && !rel_width && !rel_height;
+
         if (widget->placer_params == NULL) {
                 // At init, there is no placer, so it must be allocated
                 widget->placer_params = calloc(1, sizeof(ei_placer_params_t));
@@ -200,18 +235,245 @@ void		ei_place	(struct ei_widget_t*	widget,
                 }
         }
 
+        // The geometry must be computed again, even if it doesn't change
+        if (!is_move) widget->placer_params->is_dirty = EI_TRUE;
         ei_placer_run(widget);
 }
 
+/**
+ * @brief       Test if two rectangles are equal.
+ */
+static inline ei_bool_t rect_equal(ei_rect_t r1, ei_rect_t r2) {
+        return r1.top_left.x == r2.top_left.x && r1.top_left.y == r2.top_left.y
+               && r1.size.width == r2.size.width && r1.size.height == r2.size.height;
+}
+
+/**
+ * @brief       Test if two sizes are equal.
+ */
+static inline ei_bool_t size_equal(ei_size_t s1, ei_size_t s2) {
+        return s1.width == s2.width && s1.height == s2.height;
+}
+
+/**
+ * @brief       Translate a rectangle.
+ */
+static inline void translate_rect(ei_rect_t *rect, ei_point_t shift) {
+        rect->top_left.x += shift.x;
+        rect->top_left.y += shift.y;
+}
+
+/**
+ * @brief       Test if the new geometry of a widget is its old one translated, so that it can be computed without
+ *              calling its geomnotify function. Only the classes of the library are known. The frames and the
+ *              buttons are clipped at the top-left corner of the root window, so a location which is or would be
+ *              clipped there is not translated.
+ *
+ * @param       widget      The widget
+ * @param       shift       The translation
+ *
+ * @return      EI_TRUE if the widget can be translated.
+ */
+static ei_bool_t can_translate(struct ei_widget_t* widget, ei_point_t shift) {
+        uint32_t id = widget->wclass->id;
+        if (id != CLASS_ID_FRAME && id != CLASS_ID_BUTTON && id != CLASS_ID_TOPLEVEL) return EI_FALSE;
+
+        ei_point_t top_left = widget->screen_location.top_left;
+        return top_left.x > 0 && top_left.y > 0 && top_left.x + shift.x >= 0 && top_left.y + shift.y >= 0;
+}
+
+/**
+ * @brief       Translate the geometry of a widget and of its subtree, whose placement relative to the content
+ *              rect of the parent is unchanged. The geomnotify functions are not called, and nothing is drawn
+ *              again: the old and new locations of the moved ancestor contain the whole subtree.
+ *
+ * @param       widget      The widget
+ * @param       shift       The translation
+ */
+static void translate_subtree(struct ei_widget_t* widget, ei_point_t shift) {
+        widget->placer_params->parent_content_rect = *widget->parent->content_rect;
+        widget->placer_params->layout_stamp = g_layout_stamp;
+
+        ei_rect_t old_content_rect = *widget->content_rect;
+        translate_rect(&widget->screen_location, shift);
+        if (widget->content_rect != &widget->screen_location) translate_rect(widget->content_rect, shift);
+
+        // The parts of a toplevel are placed by its geomnotify function
+        if (widget->wclass->id == CLASS_ID_TOPLEVEL) {
+                ei_top_level_t *top_level = (ei_top_level_t *) widget;
+                translate_rect(top_level->top_bar, shift);
+                translate_rect(top_level->resize_rect, shift);
+                translate_rect(&top_level->close_button->widget.screen_location, shift);
+                if (top_level->close_button->widget.content_rect != &top_level->close_button->widget.screen_location) {
+                        translate_rect(top_level->close_button->widget.content_rect, shift);
+                }
+        }
+
+        pick_index_translate(widget, shift);
+        translate_children(widget, old_content_rect, shift);
+}
+
+/**
+ * @brief       Compute the geometry of the children of a widget whose content rect has only been translated.
+ *              The children which were placed in the old content rect, and whose parameters haven't changed,
+ *              are translated with their subtree. The other ones are placed again.
+ *
+ * @param       widget              The widget
+ * @param       old_content_rect    The content rect of the widget before the translation
+ * @param       shift               The translation
+ */
+static void translate_children(struct ei_widget_t* widget, ei_rect_t old_content_rect, ei_point_t shift) {
+        for (ei_widget_t *child = widget->children_head ; child != NULL ; child = child->next_sibling) {
+                if (child->placer_params == NULL) continue;
+                if (!child->placer_params->is_dirty && rect_equal(child->placer_params->parent_content_rect, old_content_rect)
+                    && can_translate(child, shift)) {
+                        translate_subtree(child, shift);
+                } else {
+                        place_widget(child);
+                }
+        }
+}
+
+/**
+ * @brief       Compute again the geometry of the children of a widget whose content rect has changed. The children
+ *              which were already placed in this content rect, and whose parameters haven't changed, are skipped.
+ *
+ * @param       widget      The widget
+ */
+static void place_children(struct ei_widget_t* widget) {
+        for (ei_widget_t *child = widget->children_head ; child != NULL ; child = child->next_sibling) {
+                if (child->placer_params == NULL) continue;
+                if (child->placer_params->is_dirty || !rect_equal(child->placer_params->parent_content_rect, *widget->content_rect)) {
+                        place_widget(child);
+                }
+        }
+}
+
+/**
+ * @brief       Add a widget to the widgets to place at the commit of the layout transaction.
+ *
+ * @param       widget      The widget
+ */
+static void queue_widget(struct ei_widget_t* widget) {
+        if (widget->placer_params->is_queued) return;
+
+        if (g_layout_queue_length == g_layout_queue_size) {
+                g_layout_queue_size = g_layout_queue_size ? g_layout_queue_size * 2 : 64;
+                g_layout_queue = realloc(g_layout_queue, g_layout_queue_size * sizeof(layout_entry));
+        }
+
+        layout_entry *entry = &g_layout_queue[g_layout_queue_length++];
+        entry->widget = widget;
+        entry->depth = 0;
+        for (ei_widget_t *ancestor = widget->parent ; ancestor != NULL ; ancestor = ancestor->parent) {
+                ++entry->depth;
+        }
+        widget->placer_params->is_queued = EI_TRUE;
+}
+
+/**
+ * @brief       Compare two queued widgets by depth, for qsort.
+ */
+static int compare_entries(const void *e1, const void *e2) {
+        uint32_t depth1 = ((const layout_entry *) e1)->depth;
+        uint32_t depth2 = ((const layout_entry *) e2)->depth;
+        return depth1 < depth2 ? -1 : depth1 > depth2;
+}
+
+/**
+ * \brief	Opens a layout transaction: the geometry of the widgets given to \ref ei_place and
+ *		\ref ei_placer_run is not computed until \ref ei_layout_commit is called, so a widget
+ *		configured several times is placed only once. Their screen location is not updated
+ *		meanwhile, so it must not be read before the commit. Transactions can be nested,
+ *		only the outermost commit places the widgets.
+ */
+void ei_layout_begin(void) {
+        ++g_layout_depth;
+}
+
+/**
+ * \brief	Closes a layout transaction opened by \ref ei_layout_begin. If it is the outermost one,
+ *		the queued widgets are placed, parents before children, and each widget is notified
+ *		of its new geometry at most once.
+ */
+void ei_layout_commit(void) {
+        if (g_layout_depth == 0 || --g_layout_depth > 0 || g_layout_queue_length == 0) return;
+
+        // A widget placed with its parent is not placed again
+        ++g_layout_stamp;
+        qsort(g_layout_queue, g_layout_queue_length, sizeof(layout_entry), compare_entries);
+        for (uint32_t i = 0 ; i < g_layout_queue_length ; ++i) {
+                ei_widget_t *widget = g_layout_queue[i].widget;
+                if (widget == NULL) continue;
+
+                widget->placer_params->is_queued = EI_FALSE;
+                if (widget->placer_params->layout_stamp != g_layout_stamp) {
+                        place_widget(widget);
+                }
+        }
+        g_layout_queue_length = 0;
+}
+
+/**
+ * @brief       Free the memory used to queue the widgets of the layout transactions.
+ */
+void layout_release(void) {
+        free(g_layout_queue);
+        g_layout_queue = NULL;
+        g_layout_queue_length = 0;
+        g_layout_queue_size = 0;
+        g_layout_depth = 0;
+}
+
 /**
  * \brief	Tells the placer to recompute the geometry of a widget.
  *		The widget must have been previsouly placed by a call to \ref ei_place.
  *		Geometry re-computation is necessary for example when the text label of
  *		a widget has changed, and thus the widget "natural" size has changed.
+ * 		During a layout transaction, the computation is delayed until the commit.
  *
  * @param	widget		The widget which geometry must be re-computed.
  */
 void ei_placer_run(struct ei_widget_t* widget) {
+        if (g_layout_depth > 0) {
+                queue_widget(widget);
+        } else {
+                place_widget(widget);
+        }
+}
+
+/**
+ * @brief       Move a placed widget to a new absolute position, without changing its size nor its appearance.
+ *              Its pixels are copied on the window to the new location instead of being drawn again, see
+ *              \ref move_widget_pixels. During a layout transaction, the widget is placed as by \ref ei_place.
+ *
+ * @param       widget      The widget, it must be opaque on its whole screen location
+ * @param       x           The absolute x position of the widget
+ * @param       y           The absolute y position of the widget
+ */
+void move_placed_widget(struct ei_widget_t* widget, int x, int y) {
+        if (g_layout_depth > 0 || widget->placer_params == NULL) {
+                ei_place(widget, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+                return;
+        }
+
+        ei_rect_t old_location = widget->screen_location;
+        g_is_moving_pixels = EI_TRUE;
+        ei_place(widget, NULL, &x, &y, NULL, NULL, NULL, NULL, NULL, NULL);
+        g_is_moving_pixels = EI_FALSE;
+        move_widget_pixels(widget, old_location);
+}
+
+/**
+ * @brief       Compute the geometry of a widget now, then the geometry of its children if needed.
+ *
+ * @param       widget      The widget
+ */
+static void place_widget(struct ei_widget_t* widget) {
+        // The content rect of the parent is recorded, the children of the parent placed in it are up to date
+        widget->placer_params->parent_content_rect = *widget->parent->content_rect;
+        widget->placer_params->layout_stamp = g_layout_stamp;
+
         // Calculate size of widget
         ei_rect_t rect;
         rect.size.width = widget->placer_params->w_data + (int) (widget->placer_params->rw_data * widget->parent->content_rect->size.width);
@@ -270,8 +532,46 @@ void ei_placer_run(struct ei_widget_t* widget) {
                         break;
         }
 
+        // Backup the old location of the widget, it must be redrawn
+        ei_rect_t old_location = widget->screen_location;
+        ei_rect_t old_content_rect = *widget->content_rect;
+
         // Call geomnotify function to update widget proportions
         widget->wclass->geomnotifyfunc(widget, rect);
+
+        // Nothing is drawn again if the geometry is the same, unless the widget has just been placed or changed
+        ei_bool_t is_dirty = widget->placer_params->is_dirty;
+        widget->placer_params->is_dirty = EI_FALSE;
+
+        // A widget which has only moved looks the same, its own cache is still valid
+        ei_bool_t is_moved = !is_dirty && size_equal(old_location.size, widget->screen_location.size)
+                             && size_equal(old_content_rect.size, widget->content_rect->size);
+
+        if (is_dirty || !rect_equal(old_location, widget->screen_location)) {
+                // Redraw both old and new locations of the widget, the caches which contain it are outdated
+                render_cache_invalidate(is_moved ? widget->parent : widget);
+                if (!g_is_moving_pixels) {
+                        ei_app_invalidate_rect(&old_location);
+                        ei_app_invalidate_rect(&widget->screen_location);
+                }
+
+                // The picking offscreen changes at the same locations
+                invalidate_geometry_rect(&old_location);
+                invalidate_geometry_rect(&widget->screen_location);
+                pick_index_update(widget);
+        }
+
+        // The children are placed again only if the rectangle where they are placed has changed. If it has only
+        // moved, their geometry is translated.
+        if (!rect_equal(old_content_rect, *widget->content_rect)) {
+                if (is_moved) {
+                        ei_point_t shift = {widget->content_rect->top_left.x - old_content_rect.top_left.x,
+                                            widget->content_rect->top_left.y - old_content_rect.top_left.y};
+                        translate_children(widget, old_content_rect, shift);
+                } else {
+                        place_children(widget);
+                }
+        }
 }
 
 /**
@@ -281,29 +581,27 @@ void ei_placer_run(struct ei_widget_t* widget) {
  * @param	widget		The widget to remove from screen.
  */
 void ei_placer_forget(struct ei_widget_t* widget) {
-        // Delete the concerned widget in its children field parent
-        if (widget->parent){
-                if (widget == widget->parent->children_head){
-                        widget->parent->children_head = widget->parent->children_head->next_sibling;
-                        if (widget == widget->parent->children_tail){
-                                widget->parent->children_tail = NULL;
-                        }
-                } else {
-                        ei_widget_t *widget_concerned = widget->parent->children_head;
-                        while(widget_concerned->next_sibling != widget){
-                                widget_concerned = widget_concerned->next_sibling;
-                        }
-                        widget_concerned->next_sibling = widget->next_sibling;
-                        if (widget == widget->parent->children_tail){
-                                widget->parent->children_tail = widget_concerned;
-                        }
-                }
-
+        // If the widget was displayed, its location must be redrawn, also in the caches of its ancestors
+        if (widget->placer_params) {
+                render_cache_invalidate(widget->parent);
+                ei_app_invalidate_rect(&widget->screen_location);
+                invalidate_geometry_rect(&widget->screen_location);
         }
+        pick_index_remove(widget);
+
+        // Delete the concerned widget in its children field parent
+        unlink_child(widget);
 
         // Remove parent of the concerned widget
         widget->parent = NULL;
 
+        // The widget is not placed by the current layout transaction anymore
+        if (widget->placer_params && widget->placer_params->is_queued) {
+                for (uint32_t i = 0 ; i < g_layout_queue_length ; ++i) {
+                        if (g_layout_queue[i].widget == widget) g_layout_queue[i].widget = NULL;
+                }
+        }
+
         // Delete and free struct placer
         free(widget->placer_params);
         widget->placer_params = NULL;
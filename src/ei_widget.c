@@ -1,6 +1,20 @@
 #include "ei_utils.h"
 #include "ei_widget.h"
+#include "ei_application.h"
 #include "widget_manager.h"
+#include "text_cache.h"
+#include "render_cache.h"
+#include "pick_index.h"
+#include "widget_ids.h"
+#include "widget_pool.h"
+
+// How ei_widget_pick finds the widget at a location
+static ei_pick_mode_t g_pick_mode = ei_pick_offscreen;
+
+// Memory of the widgets of the library, one pool per class
+static widget_pool g_button_pool = WIDGET_POOL_INIT(ei_button_t);
+static widget_pool g_top_level_pool = WIDGET_POOL_INIT(ei_top_level_t);
+static widget_pool g_frame_pool = WIDGET_POOL_INIT(ei_frame_t);
 
 /**
  * @brief       All is in the title
@@ -8,9 +22,9 @@
  * @param       surface             Used to know rgba position in the corresponding surface
  * @param       color_to_convert    Element which is convert into ei_color_t
  *
- * @return      A color corresponding to the 32 bits give as argument. This color must be free by user.
+ * @return      A color corresponding to the 32 bits give as argument.
  */
-ei_color_t *inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert){
+ei_color_t inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert){
         // Place of colors
         int red_place;
         int green_place;
@@ -22,79 +36,90 @@ ei_color_t *inverse_map_rgba(ei_surface_t surface, uint32_t color_to_convert){
         uint8_t *p = (uint8_t *) &color_to_convert;
 
         // Associate each value of the color with the corresponding bits
-        ei_color_t *color_to_return = malloc(sizeof(ei_color_t));
-        color_to_return->red = p[red_place];
-        color_to_return->blue = p[blue_place];
-        color_to_return->green = p[green_place];
-        color_to_return->alpha = p[6 - (blue_place + red_place + green_place)];
+        ei_color_t color_to_return;
+        color_to_return.red = p[red_place];
+        color_to_return.blue = p[blue_place];
+        color_to_return.green = p[green_place];
+        color_to_return.alpha = p[6 - (blue_place + red_place + green_place)];
 
         return color_to_return;
 }
 
 /**
  * @brief       Update child field of parent. It is a course of linked list.
+ *              The stacking key of the widget becomes the greatest one among its siblings.
  *
  * @param       widget      The widget child
  * @param       parent      The child's parent which the children field needs to be updated
  */
 static void insert_child(ei_widget_t *widget, ei_widget_t *parent) {
+        widget->prev_sibling = parent->children_tail;
+        widget->next_sibling = NULL;
         if (parent->children_head) {
                 parent->children_tail->next_sibling = widget;
+                widget->stacking_key = parent->children_tail->stacking_key + 1;
         } else {
                 parent->children_head = widget;
+                widget->stacking_key = 0;
         }
         parent->children_tail = widget;
-
 }
 
 /**
- * @brief       This function return the higher id used into tree which represents all the widgets.
- *              It useful because the last element inserted is not necessarily on the bottom-right corner of the tree.
+ * @brief       Put a widget as the first child of its parent. Its stacking key becomes the
+ *              smallest one among its siblings.
  *
- * @return      An uint32_t which is the id.
+ * @param       widget      The widget child
+ * @param       parent      The child's parent which the children field needs to be updated
  */
-static uint32_t last_id(void) {
-        // Init
-        ei_widget_t *current_widget = g_root_frame;
-        uint32_t count_id = 0;
+static void insert_first_child(ei_widget_t *widget, ei_widget_t *parent) {
+        widget->prev_sibling = NULL;
+        widget->next_sibling = parent->children_head;
+        if (parent->children_head) {
+                parent->children_head->prev_sibling = widget;
+                widget->stacking_key = parent->children_head->stacking_key - 1;
+        } else {
+                parent->children_tail = widget;
+                widget->stacking_key = 0;
+        }
+        parent->children_head = widget;
+}
 
-        // Depth course of each widgets
-        do {
-                if (current_widget->children_head) {
-                        current_widget = current_widget->children_head;
-                        count_id++;
-                } else {
-                        while (current_widget != g_root_frame && current_widget->next_sibling == NULL) {
-                                current_widget = current_widget->parent;
-                        }
+/**
+ * @brief       Remove a widget from the children of its parent, in constant time thanks to the
+ *              doubly linked siblings. The parent field of the widget is kept.
+ *
+ * @param       widget      The widget child
+ */
+void unlink_child(ei_widget_t *widget) {
+        ei_widget_t *parent = widget->parent;
+        if (parent == NULL) {
+                return;
+        }
 
-                        if (current_widget->next_sibling) {
-                                current_widget = current_widget->next_sibling;
-                                count_id++;
-                        }
-                }
-        } while (current_widget != g_root_frame);
-        return count_id;
+        if (widget->prev_sibling) {
+                widget->prev_sibling->next_sibling = widget->next_sibling;
+        } else {
+                parent->children_head = widget->next_sibling;
+        }
+        if (widget->next_sibling) {
+                widget->next_sibling->prev_sibling = widget->prev_sibling;
+        } else {
+                parent->children_tail = widget->prev_sibling;
+        }
+        widget->next_sibling = NULL;
+        widget->prev_sibling = NULL;
 }
 
 /**
- * @brief       Return widget class which correspond to class name give in parameter
- *
- * @param       ll              The linked list which contained all classes (button, top-level and frame)
- * @param       class_name      The class name
+ * @brief       Invalidate what changes on screen when a widget changes its place among its siblings
  *
- * @return      The class corresponding of class_name if exists. If not, return NULL;
+ * @param       widget      The widget which has been moved in the children list
  */
-ei_widgetclass_t *get_class(ei_widgetclass_t *ll, ei_widgetclass_name_t class_name) {
-        while (ll != NULL) {
-                char * class_name_node = ll->name;
-                char * class_name_param = ei_widgetclass_stringname(class_name);
-                if (strcmp(class_name_node, class_name_param) == 0) {
-                        return ll;
-                }
-                ll = ll->next;
-        }
-        return ll;
+static void invalidate_stacking(ei_widget_t *widget) {
+        render_cache_invalidate(widget->parent);
+        ei_app_invalidate_rect(&widget->screen_location);
+        invalidate_geometry_rect(&widget->screen_location);
 }
 
 /*
@@ -106,10 +131,10 @@ ei_widgetclass_t *get_class(ei_widgetclass_t *ll, ei_widgetclass_name_t class_na
  * @return      The corresponding widget
  */
 ei_widget_t* button_alloc_func() {
-        ei_button_t * button = calloc(1, sizeof(ei_button_t));
+        ei_button_t * button = widget_pool_alloc(&g_button_pool);
 
-        // Alloc memory for specific widget attributes
-        button->widget.content_rect = calloc(1, sizeof(ei_rect_t));
+        // Specific widget attributes are stored in the same block
+        button->widget.content_rect = &button->widget.content_rect_data;
 
         return (ei_widget_t *) button;
 }
@@ -119,15 +144,16 @@ ei_widget_t* button_alloc_func() {
  * @return      The corresponding widget
  */
 ei_widget_t* top_level_alloc_func() {
-        ei_top_level_t *toplevel = calloc(1, sizeof(ei_top_level_t));
-        toplevel->resize_rect = calloc(1, sizeof(ei_rect_t));
-        toplevel->top_bar = calloc(1, sizeof(ei_rect_t));
+        ei_top_level_t *toplevel = widget_pool_alloc(&g_top_level_pool);
 
-        // Alloc memory for specific widget attributes
-        toplevel->widget.content_rect = calloc(1, sizeof(ei_rect_t));
+        // Specific widget attributes are stored in the same block
+        toplevel->resize_rect = &toplevel->resize_rect_data;
+        toplevel->top_bar = &toplevel->top_bar_data;
+        toplevel->widget.content_rect = &toplevel->widget.content_rect_data;
 
-        // Initialisation of close button widget
-        toplevel->close_button = (ei_button_t *) button_alloc_func();
+        // Initialisation of close button widget, which is also in the block
+        toplevel->close_button = &toplevel->close_button_data;
+        toplevel->close_button->widget.content_rect = &toplevel->close_button->widget.content_rect_data;
         toplevel->close_button->widget.parent = (ei_widget_t *) toplevel;
 
         return (ei_widget_t *) toplevel;
@@ -138,14 +164,37 @@ ei_widget_t* top_level_alloc_func() {
  * @return      The corresponding widget
  */
 ei_widget_t* frame_alloc_func() {
-        ei_frame_t * frame = calloc(1, sizeof(ei_frame_t));
+        ei_frame_t * frame = widget_pool_alloc(&g_frame_pool);
 
-        // Alloc memory for specific widget attributes
-        frame->widget.content_rect = calloc(1, sizeof(ei_rect_t));
+        // Specific widget attributes are stored in the same block
+        frame->widget.content_rect = &frame->widget.content_rect_data;
 
         return (ei_widget_t *) frame;
 }
 
+/**
+ * @brief       Return the pool which allocated a widget.
+ *
+ * @param       widget      The widget
+ *
+ * @return      The pool, or NULL if the widget was allocated by a class registered by the programmer.
+ */
+static widget_pool *widget_pool_of(ei_widget_t *widget) {
+        if (widget->wclass->allocfunc == &button_alloc_func) return &g_button_pool;
+        if (widget->wclass->allocfunc == &top_level_alloc_func) return &g_top_level_pool;
+        if (widget->wclass->allocfunc == &frame_alloc_func) return &g_frame_pool;
+        return NULL;
+}
+
+/**
+ * @brief       Free the pools of memory used by the widgets of the library. All the widgets must be destroyed.
+ */
+void widget_pools_release(void) {
+        widget_pool_release(&g_button_pool);
+        widget_pool_release(&g_top_level_pool);
+        widget_pool_release(&g_frame_pool);
+}
+
 /*
  * Release functions
  */
@@ -161,7 +210,6 @@ void button_release(struct ei_widget_t*	widget) {
         ei_button_t * button_widget = (ei_button_t*) widget;
 
         if (button_widget->text) free(button_widget->text);
-        if (button_widget->img_rect) free(button_widget->img_rect);
         if (button_widget->img) hw_surface_free(button_widget->img);
 }
 
@@ -175,24 +223,17 @@ void top_level_release(struct ei_widget_t* widget) {
         ei_top_level_t * top_level_widget = (ei_top_level_t*) widget;
 
         if (top_level_widget->title) free(top_level_widget->title);
-        //if (top_level_widget->min_size) free(top_level_widget->min_size);
-        if (top_level_widget->resize_rect) free(top_level_widget->resize_rect);
-        if (top_level_widget->top_bar) free(top_level_widget->top_bar);
 
-        // Delete and free close button
+        // Delete close button, its memory is in the block of the toplevel
 
         // Call destructor if it provided by the user
         if (top_level_widget->close_button->widget.destructor) {
                 top_level_widget->close_button->widget.destructor(widget);
         }
         button_release((ei_widget_t *) top_level_widget->close_button);
-        free(top_level_widget->close_button->widget.pick_color);
         free(top_level_widget->close_button->widget.placer_params);
         top_level_widget->close_button->widget.parent = NULL;
         top_level_widget->close_button->widget.placer_params = NULL;
-        top_level_widget->close_button->widget.content_rect = NULL;
-        top_level_widget->close_button->widget.pick_color = NULL;
-        free(top_level_widget->close_button);
 }
 
 /**
@@ -205,7 +246,6 @@ void frame_release(struct ei_widget_t* widget) {
         ei_frame_t * frame_widget = (ei_frame_t*) widget;
 
         if (frame_widget->text) free(frame_widget->text);
-        if (frame_widget->img_rect) free(frame_widget->img_rect);
         if (frame_widget->img) hw_surface_free(frame_widget->img);
 }
 
@@ -264,7 +304,8 @@ void set_default_top_level (ei_widget_t *widget) {
         top_level_widget->color = default_top_level_color;
         top_level_widget->border_width = default_top_level_border_width;
         top_level_widget->closable = default_top_level_closable;
-        top_level_widget->min_size = &default_top_level_min_size;
+        top_level_widget->min_size_data = default_top_level_min_size;
+        top_level_widget->min_size = &top_level_widget->min_size_data;
         top_level_widget->current_event = event_none;
 }
 
@@ -363,7 +404,7 @@ void top_level_geomnotifyfunc (struct ei_widget_t* widget, ei_rect_t rect) {
 
         // Get text size
         ei_size_t *text_size = calloc(1, sizeof(ei_size_t));
-        hw_text_compute_size(top_level_widget->title, ei_default_font, &(text_size->width), &(text_size->height));
+        text_cache_compute_size(top_level_widget->title, ei_default_font, &(text_size->width), &(text_size->height));
 
         // Resize screen_location including border and top_bar
         widget->screen_location.size.width += 2*(top_level_widget->border_width);
@@ -472,20 +513,41 @@ void			ei_frame_configure		(ei_widget_t*		widget,
                                                        ei_anchor_t*		img_anchor) {
         // Cast into frame widget to configure it
         ei_frame_t * frame_widget = (ei_frame_t*) widget;
+        ei_placer_params_t *placer_params = frame_widget->widget.placer_params;
+
+        // The border changes the part of the frame which is in the picking offscreen
+        if (border_width) {
+                invalidate_geometry_rect(&widget->screen_location);
+        }
+
+        // The border is set before the frame is placed, its content rect depends on it
+        ei_bool_t must_place = border_width != NULL && *border_width != frame_widget->border_width;
+        frame_widget->color = color != NULL ? *color : frame_widget->color;
+        frame_widget->border_width = border_width != NULL ? *border_width : frame_widget-> border_width;
+        frame_widget->relief = relief != NULL ? *relief : frame_widget-> relief;
 
         if (requested_size) {
                 frame_widget->widget.requested_size = *requested_size;
-                if (frame_widget->widget.placer_params) {
+                if (placer_params == NULL) {
+                        ei_place(widget, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+                } else if (placer_params->w_data != requested_size->width || placer_params->h_data != requested_size->height) {
                         // If there is already a placer, change width and height
-                        frame_widget->widget.placer_params->w_data = requested_size->width;
-                        frame_widget->widget.placer_params->h_data = requested_size->height;
+                        placer_params->w_data = requested_size->width;
+                        placer_params->h_data = requested_size->height;
+                        must_place = EI_TRUE;
                 }
-                ei_place(widget, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
         }
 
-        frame_widget->color = color != NULL ? *color : frame_widget->color;
-        frame_widget->border_width = border_width != NULL ? *border_width : frame_widget-> border_width;
-        frame_widget->relief = relief != NULL ? *relief : frame_widget-> relief;
+        // The placer is run only if the size or the border have changed
+        if (placer_params != NULL && must_place) {
+                placer_params->is_dirty = EI_TRUE;
+                ei_placer_run(widget);
+        }
+
+        // The size of the old text is not needed anymore if the text or the font changes
+        if ((text || text_font) && frame_widget->text) {
+                text_cache_forget_size(frame_widget->text, frame_widget->text_font);
+        }
 
         if (text) {
                 // Delete the old text if exists
@@ -500,10 +562,8 @@ void			ei_frame_configure		(ei_widget_t*		widget,
 
 
         if (img_rect) {
-                if (frame_widget->img_rect == NULL) {
-                        // Allocate memory if its the first time
-                        frame_widget->img_rect = calloc(1, sizeof(ei_rect_t));
-                }
+                // The rectangle is stored in the widget
+                frame_widget->img_rect = &frame_widget->img_rect_data;
                 frame_widget->img_rect->size = (*img_rect)->size;
                 frame_widget->img_rect->top_left = (*img_rect)->top_left;
         }
@@ -521,6 +581,13 @@ void			ei_frame_configure		(ei_widget_t*		widget,
         frame_widget->text_color = text_color != NULL ? *text_color : frame_widget-> text_color;
         frame_widget->text_anchor = text_anchor != NULL ? *text_anchor : frame_widget-> text_anchor;
         frame_widget->img_anchor = img_anchor != NULL ? *img_anchor : frame_widget-> img_anchor;
+
+        // The widget must be redrawn, also in the caches which contain it
+        render_cache_invalidate(widget);
+        ei_app_invalidate_rect(&widget->screen_location);
+        if (border_width) {
+                pick_index_update(widget);
+        }
 }
 
 
@@ -558,12 +625,31 @@ void			ei_button_configure		(ei_widget_t*		widget,
         // Cast into button widget to configure it
         ei_button_t * button_widget = (ei_button_t*) widget;
 
+        // The border and the corners change the part of the button which is in the picking offscreen
+        if (border_width || corner_radius) {
+                invalidate_geometry_rect(&widget->screen_location);
+        }
+
+        // The border is set before the button is placed, its content rect depends on it
+        ei_placer_params_t *placer_params = button_widget->widget.placer_params;
+        ei_bool_t must_place = border_width != NULL && *border_width != button_widget->border_width;
         button_widget->widget.requested_size = requested_size != NULL ? *requested_size : button_widget->widget.requested_size;
         button_widget->color = color != NULL ? *color : button_widget->color;
         button_widget->border_width = border_width != NULL ? *border_width : button_widget-> border_width;
         button_widget->corner_radius = corner_radius != NULL ? *corner_radius : button_widget->corner_radius;
         button_widget->relief = relief != NULL ? *relief : button_widget->relief;
 
+        // A placed button is placed again if its border has changed
+        if (placer_params != NULL && must_place) {
+                placer_params->is_dirty = EI_TRUE;
+                ei_placer_run(widget);
+        }
+
+        // The size of the old text is not needed anymore if the text or the font changes
+        if ((text || text_font) && button_widget->text) {
+                text_cache_forget_size(button_widget->text, button_widget->text_font);
+        }
+
         if (text) {
                 // Delete the old text if exists
                 if (button_widget->text) {
@@ -577,10 +663,8 @@ void			ei_button_configure		(ei_widget_t*		widget,
 
 
         if (img_rect) {
-                if (button_widget->img_rect == NULL) {
-                        // Allocate memory if its the first time
-                        button_widget->img_rect = calloc(1, sizeof(ei_rect_t));
-                }
+                // The rectangle is stored in the widget
+                button_widget->img_rect = &button_widget->img_rect_data;
                 button_widget->img_rect->size = (*img_rect)->size;
                 button_widget->img_rect->top_left = (*img_rect)->top_left;
         }
@@ -598,6 +682,13 @@ void			ei_button_configure		(ei_widget_t*		widget,
         button_widget->img_anchor = img_anchor != NULL ? *img_anchor : button_widget->img_anchor;
         button_widget->callback = callback != NULL ? *callback : button_widget->callback;
         button_widget->user_param = user_param != NULL ? *user_param : button_widget->user_param;
+
+        // The widget must be redrawn, also in the caches which contain it
+        render_cache_invalidate(widget);
+        ei_app_invalidate_rect(&widget->screen_location);
+        if (border_width || corner_radius) {
+                pick_index_update(widget);
+        }
 }
 
 /**
@@ -639,9 +730,8 @@ void			ei_toplevel_configure		(ei_widget_t*		widget,
         top_level_widget->resizable = resizable != NULL ? *resizable :top_level_widget->resizable;
 
         if (min_size) {
-                free(top_level_widget->min_size);
-                top_level_widget->min_size = malloc(sizeof(ei_size_t));
-                top_level_widget->min_size = *min_size;
+                // The size is copied in the widget, NULL gives the default size
+                top_level_widget->min_size_data = *min_size ? **min_size : default_top_level_min_size;
         }
 
         if (border_width) {
@@ -658,6 +748,11 @@ void			ei_toplevel_configure		(ei_widget_t*		widget,
         }
 
         if (title) {
+                // The size of the old title is not needed anymore
+                if (top_level_widget->title && top_level_widget->title != *title) {
+                        text_cache_forget_size(top_level_widget->title, ei_default_font);
+                }
+
                 if (top_level_widget->widget.placer_params && top_level_widget->title != *title) {
                         // Case when top level has already called ei_place
                         free(top_level_widget->title);
@@ -673,6 +768,10 @@ void			ei_toplevel_configure		(ei_widget_t*		widget,
                         strcpy(top_level_widget->title, *title);
                 }
         }
+
+        // The widget must be redrawn, also in the caches which contain it
+        render_cache_invalidate(widget);
+        ei_app_invalidate_rect(&widget->screen_location);
 }
 
 /**
@@ -693,9 +792,7 @@ ei_widget_t*		ei_widget_create		(ei_widgetclass_name_t	class_name,
                                                              ei_widget_t*		parent,
                                                              void*			user_data,
                                                              ei_widget_destructor_t destructor) {
-        // ll_classes is a linked list of ei_widgetclass_t elements.
-        ei_widgetclass_t *ll_classes = get_linked_list_classes();
-        ei_widgetclass_t *class = get_class(ll_classes, class_name);
+        ei_widgetclass_t *class = ei_widgetclass_from_name(class_name);
 
         if (class){
                 // Initialisation by functions of ei_widgetclass_t
@@ -711,12 +808,15 @@ ei_widget_t*		ei_widget_create		(ei_widgetclass_name_t	class_name,
 
                 // Update parent's child, only if parent exists
                 if (parent) {
-                        uint32_t last_widget_id = last_id();
                         insert_child(widget_to_return, parent);
-                        widget_to_return->pick_id = last_widget_id + 1;
-                        widget_to_return->pick_color = inverse_map_rgba(g_offscreen, widget_to_return->pick_id);
+                        widget_to_return->pick_id = widget_ids_new();
                 }
 
+                // The pick color is stored in the widget, the root widget has the id 0
+                widget_to_return->pick_color_data = inverse_map_rgba(g_offscreen, widget_to_return->pick_id);
+                widget_to_return->pick_color = &widget_to_return->pick_color_data;
+                widget_ids_register(widget_to_return);
+
                 // We return a pointer on the new ei_widget_t
                 return widget_to_return;
         }
@@ -736,12 +836,20 @@ static void free_widget(ei_widget_t *widget) {
                 widget->destructor(widget);
         }
         ei_placer_forget(widget);
+        widget_ids_forget(widget);
         widget->wclass->releasefunc(widget);
-        free(widget->pick_color);
-        free(widget->content_rect);
-        widget->pick_color = NULL;
-        widget->content_rect = NULL;
-        free(widget);
+        render_cache_free(widget->render_cache);
+
+        // The widgets of the library are in a pool, with their content rect and their pick color
+        widget_pool *pool = widget_pool_of(widget);
+        if (pool) {
+                widget_pool_free(pool, widget);
+        } else {
+                if (widget->content_rect != &widget->content_rect_data && widget->content_rect != &widget->screen_location) {
+                        free(widget->content_rect);
+                }
+                free(widget);
+        }
 }
 
 /**
@@ -790,6 +898,19 @@ void			ei_widget_destroy		(ei_widget_t*		widget) {
  *				at this location (except for the root widget).
  */
 ei_widget_t*		ei_widget_pick			(ei_point_t*		where){
+        if (g_pick_mode == ei_pick_geometry) {
+                // Only the root widget is not in the spatial index
+                ei_widget_t *picked = pick_index_find(*where);
+                ei_size_t root_size = g_root_frame->screen_location.size;
+                if (picked == NULL && where->x >= 0 && where->y >= 0 && where->x < root_size.width && where->y < root_size.height) {
+                        picked = g_root_frame;
+                }
+                return picked;
+        }
+
+        // The picking offscreen is drawn only when it is needed
+        update_pick_offscreen();
+
         // Otherwise, we search the event to treat
         // Parameters of the offscreen
         hw_surface_lock(g_offscreen);
@@ -800,32 +921,74 @@ ei_widget_t*		ei_widget_pick			(ei_point_t*		where){
         clicked_pixel += (offscreen_size.width * where->y) + where->x;
         uint32_t widget_id = *clicked_pixel;
 
-        // Test if the clicked pixel is in the g_root_frame
-        ei_widget_t *widget_to_treat = g_root_frame;
-        if (widget_to_treat->pick_id == widget_id){
-                return widget_to_treat;
+        hw_surface_unlock(g_offscreen);
+
+        // The widget is found directly from its id
+        return widget_ids_find(widget_id);
+}
+
+/**
+ * @brief	Chooses how \ref ei_widget_pick finds the widget at a location. By default, the picking
+ *		offscreen is used. The geometry mode doesn't draw the picking offscreen, which is
+ *		faster when the widgets move often, but it only knows the shapes of the frames, the
+ *		buttons and the toplevels.
+ *
+ * @param	mode		The pick mode.
+ */
+void			ei_widget_set_pick_mode		(ei_pick_mode_t		mode) {
+        g_pick_mode = mode;
+}
+
+/**
+ * @brief	Enables or disables the offscreen cache of a widget. When enabled, the widget and its
+ *		descendants are rendered once in an offscreen surface, which is then copied on the
+ *		root window. They are rendered again only when one of them is configured, moved,
+ *		resized, created or destroyed. Useful for complex panels which rarely change.
+ *
+ * @param	widget		The widget.
+ * @param	cached		EI_TRUE to enable the cache, EI_FALSE to disable it and release its memory.
+ */
+void			ei_widget_set_cached		(ei_widget_t*		widget,
+                                                         ei_bool_t		cached) {
+        if (cached && widget->render_cache == NULL) {
+                // The subtree is rendered in the cache on the next redraw
+                widget->render_cache = render_cache_create();
+        } else if (!cached && widget->render_cache) {
+                render_cache_free(widget->render_cache);
+                widget->render_cache = NULL;
         }
+}
 
-        // Depth course of each widgets
-        do {
-                if (widget_to_treat->children_head) {
-                        widget_to_treat = widget_to_treat->children_head;
-                        if (widget_to_treat->pick_id == widget_id){
-                                return widget_to_treat;
-                        }
-                } else {
-                        while (widget_to_treat != g_root_frame && widget_to_treat->next_sibling == NULL) {
-                                widget_to_treat = widget_to_treat->parent;
-                        }
+/**
+ * @brief	Puts a widget in front of its siblings: it becomes the last child of its parent, so it
+ *		is drawn over them and picked before them. Does nothing for the root widget.
+ *
+ * @param	widget		The widget to raise.
+ */
+void			ei_widget_raise			(ei_widget_t*		widget) {
+        if (widget->parent == NULL || widget == widget->parent->children_tail) {
+                return;
+        }
+        ei_widget_t *parent = widget->parent;
+        unlink_child(widget);
+        insert_child(widget, parent);
+        invalidate_stacking(widget);
+}
 
-                        if (widget_to_treat->next_sibling) {
-                                widget_to_treat = widget_to_treat->next_sibling;
-                                if (widget_to_treat->pick_id == widget_id){
-                                        return widget_to_treat;
-                                }
-                        }
-                }
-        } while (widget_to_treat != g_root_frame);
+/**
+ * @brief	Puts a widget behind its siblings: it becomes the first child of its parent, so they
+ *		are drawn over it. Does nothing for the root widget.
+ *
+ * @param	widget		The widget to lower.
+ */
+void			ei_widget_lower			(ei_widget_t*		widget) {
+        if (widget->parent == NULL || widget == widget->parent->children_head) {
+                return;
+        }
+        ei_widget_t *parent = widget->parent;
+        unlink_child(widget);
+        insert_first_child(widget, parent);
+        invalidate_stacking(widget);
 }
 
 
@@ -839,51 +1002,50 @@ ei_widget_t*		ei_widget_pick			(ei_point_t*		where){
  *
  * @return      A point which represents coordinates of top-left text place
  */
- ei_point_t* text_place(ei_anchor_t *text_anchor, ei_size_t *text_size, ei_point_t *widget_place, ei_size_t *widget_size) {
-         // Allocate memory
-        ei_point_t *text_coord = malloc(sizeof(ei_point_t));
+ ei_point_t text_place(ei_anchor_t *text_anchor, ei_size_t *text_size, ei_point_t *widget_place, ei_size_t *widget_size) {
+        ei_point_t text_coord = ei_point_zero();
 
         // Adapt top-left coordinates at the anchor given in parameter
         switch (*text_anchor) {
                 case ei_anc_center:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width) / 2;
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height) / 2;
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width) / 2;
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height) / 2;
                         break;
                 case ei_anc_north:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width) / 2;
-                        text_coord->y = widget_place->y;
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width) / 2;
+                        text_coord.y = widget_place->y;
                         break;
                 case ei_anc_northeast:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width);
-                        text_coord->y = widget_place->y;
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width);
+                        text_coord.y = widget_place->y;
                         break;
                 case ei_anc_northwest:
-                        text_coord->x = widget_place->x;
-                        text_coord->y = widget_place->y;
+                        text_coord.x = widget_place->x;
+                        text_coord.y = widget_place->y;
                         break;
                 case ei_anc_south:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width) / 2;
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height);
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width) / 2;
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height);
                         break;
                 case ei_anc_southeast:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width);
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height);
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width);
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height);
                         break;
                 case ei_anc_southwest:
-                        text_coord->x = widget_place->x;
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height);
+                        text_coord.x = widget_place->x;
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height);
                         break;
                 case ei_anc_east:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width);
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height) / 2;
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width);
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height) / 2;
                         break;
                 case ei_anc_west:
-                        text_coord->x = widget_place->x;
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height) / 2;
+                        text_coord.x = widget_place->x;
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height) / 2;
                         break;
                 case ei_anc_none:
-                        text_coord->x = widget_place->x + (widget_size->width - text_size->width) / 2;
-                        text_coord->y = widget_place->y + (widget_size->height - text_size->height) / 2;
+                        text_coord.x = widget_place->x + (widget_size->width - text_size->width) / 2;
+                        text_coord.y = widget_place->y + (widget_size->height - text_size->height) / 2;
                         break;
         }
         return text_coord;
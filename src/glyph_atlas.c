@@ -0,0 +1,390 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "glyph_atlas.h"
+#include "ei_draw.h"
+#include "ei_utils.h"
+#include "pixel_kernels.h"
+#include "text_cache.h"
+
+// Width of a new atlas, in pixels
+#define GLYPH_ATLAS_WIDTH 512
+
+// Value of the kerning of an ASCII pair which has not been measured yet
+#define KERNING_UNKNOWN INT8_MIN
+
+/**
+ * @brief       A glyph stored in an atlas.
+ */
+typedef struct glyph {
+        uint32_t        codepoint;      ///< Unicode code point of the glyph
+        int32_t         x, y;           ///< Top-left corner of the glyph in the atlas
+        int32_t         advance;        ///< Width of the glyph, the next one is placed just after it
+        int32_t         height;         ///< Height of the glyph
+        struct glyph*   next;           ///< Next glyph which is not in the ASCII range
+} glyph;
+
+/**
+ * @brief       Atlas of the glyphs of a font. Glyphs are packed on shelves, from left to right.
+ */
+typedef struct glyph_atlas {
+        ei_font_t               font;           ///< The font of the glyphs
+        ei_surface_t            format;         ///< A surface rendered with the font, gives the channel indices
+        uint8_t*                coverage;       ///< Coverage of the glyphs, one byte per pixel
+        ei_size_t               size;           ///< Size of the coverage array
+        int32_t                 shelf_x;        ///< First free column of the current shelf
+        int32_t                 shelf_y;        ///< Top of the current shelf
+        int32_t                 shelf_height;   ///< Height of the highest glyph of the current shelf
+        int32_t                 line_height;    ///< Height of the texts rendered with the font
+        glyph*                  ascii[128];     ///< Glyphs of the ASCII range, indexed by code point
+        glyph*                  others;         ///< Linked list of the other glyphs
+        int8_t*                 kerning;        ///< Kerning of the pairs of ASCII glyphs, allocated on first use
+        struct glyph_atlas*     next;           ///< Atlas of the next font
+} glyph_atlas;
+
+// Linked list of the atlases, one per font
+static glyph_atlas *g_atlases = NULL;
+
+/**
+ * @brief       Decode the next character of a UTF-8 string.
+ *
+ * @param       text        The address of the string, it is moved after the character
+ * @param       length      Where to store the number of bytes of the character
+ *
+ * @return      The code point of the character. Invalid bytes are returned one by one,
+ *              with a code point out of the Unicode range.
+ */
+static uint32_t decode_utf8(const char **text, int *length) {
+        const unsigned char *bytes = (const unsigned char *) *text;
+        uint32_t codepoint;
+        int expected;
+
+        if (bytes[0] < 0x80) {
+                codepoint = bytes[0];
+                expected = 1;
+        } else if ((bytes[0] & 0xE0) == 0xC0) {
+                codepoint = bytes[0] & 0x1F;
+                expected = 2;
+        } else if ((bytes[0] & 0xF0) == 0xE0) {
+                codepoint = bytes[0] & 0x0F;
+                expected = 3;
+        } else if ((bytes[0] & 0xF8) == 0xF0) {
+                codepoint = bytes[0] & 0x07;
+                expected = 4;
+        } else {
+                expected = 0;
+        }
+
+        // Add the continuation bytes
+        for (int i = 1 ; i < expected ; ++i) {
+                if ((bytes[i] & 0xC0) != 0x80) {
+                        expected = 0;
+                        break;
+                }
+                codepoint = (codepoint << 6) | (bytes[i] & 0x3F);
+        }
+
+        if (expected == 0) {
+                // Invalid byte
+                codepoint = 0x110000u + bytes[0];
+                expected = 1;
+        }
+
+        *length = expected;
+        *text += expected;
+        return codepoint;
+}
+
+/**
+ * @brief       Make the coverage array of an atlas bigger, the stored glyphs are kept.
+ *
+ * @param       atlas       The atlas
+ * @param       size        The new size, not smaller than the current one
+ */
+static void grow_atlas(glyph_atlas *atlas, ei_size_t size) {
+        uint8_t *coverage = calloc((size_t) size.width * size.height, 1);
+        for (int32_t y = 0 ; y < atlas->size.height ; ++y) {
+                memcpy(coverage + y * size.width, atlas->coverage + y * atlas->size.width, atlas->size.width);
+        }
+
+        free(atlas->coverage);
+        atlas->coverage = coverage;
+        atlas->size = size;
+}
+
+/**
+ * @brief       Rasterize a glyph and store it in the atlas.
+ *
+ * @param       atlas       The atlas
+ * @param       bytes       The UTF-8 bytes of the glyph
+ * @param       length      The number of bytes
+ * @param       codepoint   The code point of the glyph
+ *
+ * @return      The new glyph.
+ */
+static glyph *add_glyph(glyph_atlas *atlas, const char *bytes, int length, uint32_t codepoint) {
+        glyph *new_glyph = calloc(1, sizeof(glyph));
+        new_glyph->codepoint = codepoint;
+        if (codepoint < 128) {
+                atlas->ascii[codepoint] = new_glyph;
+        } else {
+                new_glyph->next = atlas->others;
+                atlas->others = new_glyph;
+        }
+
+        // Rasterize the glyph alone, in white: only its alpha channel is used
+        char glyph_text[5];
+        memcpy(glyph_text, bytes, length);
+        glyph_text[length] = '\0';
+        ei_surface_t surface = hw_text_create_surface(glyph_text, atlas->font, (ei_color_t) {0xff, 0xff, 0xff, 0xff});
+        if (surface == NULL) return new_glyph;
+
+        ei_size_t size = hw_surface_get_size(surface);
+        new_glyph->advance = size.width;
+        new_glyph->height = size.height;
+        atlas->line_height = size.height > atlas->line_height ? size.height : atlas->line_height;
+
+        // Find a place in the atlas: on the current shelf, or on a new one
+        if (size.width > atlas->size.width) {
+                grow_atlas(atlas, ei_size(size.width > GLYPH_ATLAS_WIDTH ? size.width : GLYPH_ATLAS_WIDTH, atlas->size.height));
+        }
+        if (atlas->shelf_x + size.width > atlas->size.width) {
+                atlas->shelf_y += atlas->shelf_height;
+                atlas->shelf_x = 0;
+                atlas->shelf_height = 0;
+        }
+        if (atlas->shelf_y + size.height > atlas->size.height) {
+                int32_t height = 2 * atlas->size.height > atlas->shelf_y + size.height ? 2 * atlas->size.height : atlas->shelf_y + size.height;
+                grow_atlas(atlas, ei_size(atlas->size.width, height));
+        }
+        new_glyph->x = atlas->shelf_x;
+        new_glyph->y = atlas->shelf_y;
+        atlas->shelf_x += size.width;
+        atlas->shelf_height = size.height > atlas->shelf_height ? size.height : atlas->shelf_height;
+
+        // Copy the alpha channel of the glyph
+        int red_place; int green_place;
+        int blue_place; int alpha_place;
+        hw_surface_get_channel_indices(surface, &red_place, &green_place, &blue_place, &alpha_place);
+        alpha_place = 6 - (blue_place + red_place + green_place);
+
+        hw_surface_lock(surface);
+        uint8_t *pixel = hw_surface_get_buffer(surface);
+        for (int32_t y = 0 ; y < size.height ; ++y) {
+                uint8_t *coverage = atlas->coverage + (new_glyph->y + y) * atlas->size.width + new_glyph->x;
+                for (int32_t x = 0 ; x < size.width ; ++x, pixel += 4) {
+                        coverage[x] = pixel[alpha_place];
+                }
+        }
+        hw_surface_unlock(surface);
+
+        // The first surface is kept to create the texts with the same channel indices
+        if (atlas->format == NULL) {
+                atlas->format = surface;
+        } else {
+                hw_surface_free(surface);
+        }
+        return new_glyph;
+}
+
+/**
+ * @brief       Return the glyph of the next character of a string, it is added to the atlas if needed.
+ *
+ * @param       atlas       The atlas
+ * @param       text        The address of the string, it is moved after the character
+ *
+ * @return      The glyph.
+ */
+static glyph *next_glyph(glyph_atlas *atlas, const char **text) {
+        const char *bytes = *text;
+        int length;
+        uint32_t codepoint = decode_utf8(text, &length);
+
+        glyph *found = NULL;
+        if (codepoint < 128) {
+                found = atlas->ascii[codepoint];
+        } else {
+                for (found = atlas->others ; found != NULL && found->codepoint != codepoint ; found = found->next);
+        }
+        return found ? found : add_glyph(atlas, bytes, length, codepoint);
+}
+
+/**
+ * @brief       Return the kerning of a pair of glyphs: the shift of the second glyph, compared to its
+ *              place right after the advance of the first one. It is measured with \ref hw_text_compute_size,
+ *              the same function as the size of the texts, and kept for the pairs of ASCII glyphs.
+ *
+ * @param       atlas           The atlas
+ * @param       first           The UTF-8 bytes of the first glyph, it is followed by the second one
+ * @param       first_glyph     The first glyph
+ * @param       second_glyph    The second glyph
+ * @param       length          The number of bytes of both glyphs
+ *
+ * @return      The kerning, in pixels.
+ */
+static int32_t pair_kerning(glyph_atlas *atlas, const char *first, glyph *first_glyph, glyph *second_glyph, int length) {
+        int8_t *known = NULL;
+        if (first_glyph->codepoint < 128 && second_glyph->codepoint < 128) {
+                if (atlas->kerning == NULL) {
+                        atlas->kerning = malloc(128 * 128);
+                        memset(atlas->kerning, KERNING_UNKNOWN, 128 * 128);
+                }
+                known = &atlas->kerning[first_glyph->codepoint * 128 + second_glyph->codepoint];
+                if (*known != KERNING_UNKNOWN) return *known;
+        }
+
+        char pair_text[9];
+        memcpy(pair_text, first, length);
+        pair_text[length] = '\0';
+
+        int width, height;
+        hw_text_compute_size(pair_text, atlas->font, &width, &height);
+        int32_t kerning = width - first_glyph->advance - second_glyph->advance;
+
+        if (known) {
+                kerning = kerning < -INT8_MAX ? -INT8_MAX : (kerning > INT8_MAX ? INT8_MAX : kerning);
+                *known = (int8_t) kerning;
+        }
+        return kerning;
+}
+
+/**
+ * @brief       Return the atlas of a font, it is created if needed.
+ *
+ * @param       font        The font
+ *
+ * @return      The atlas.
+ */
+static glyph_atlas *get_atlas(ei_font_t font) {
+        for (glyph_atlas *atlas = g_atlases ; atlas != NULL ; atlas = atlas->next) {
+                if (atlas->font == font) return atlas;
+        }
+
+        glyph_atlas *atlas = calloc(1, sizeof(glyph_atlas));
+        atlas->font = font;
+        atlas->next = g_atlases;
+        g_atlases = atlas;
+
+        // The space gives the channel indices and the height of the texts, even for empty texts
+        const char *space = " ";
+        next_glyph(atlas, &space);
+        return atlas;
+}
+
+/**
+ * @brief       Create a surface containing a text, composed from the glyphs of the atlas of the font.
+ *              The glyphs which are not yet in the atlas are rasterized and added to it.
+ *              Glyphs are placed one after the other using their advance and the kerning of each pair.
+ *              The surface has the size given by \ref text_cache_compute_size, which is used to place
+ *              the texts, so the composed text is never wider than the room made for it.
+ *
+ * @param       text        The string of the text, in UTF-8. Can't be NULL.
+ * @param       font        The font used to render the text. Can't be NULL.
+ * @param       color       The text color. The alpha parameter is not used, the alpha channel of the
+ *                          surface is the coverage of the glyphs (anti-aliasing).
+ *
+ * @return      The surface, just big enough to contain the text. The caller is responsible to release it
+ *              with \ref hw_surface_free.
+ */
+ei_surface_t glyph_atlas_create_text_surface(const char *text, ei_font_t font, ei_color_t color) {
+        glyph_atlas *atlas = get_atlas(font);
+        if (atlas->format == NULL) return hw_text_create_surface(text, font, color);
+
+        // The size is the one used to place the text
+        int width, height;
+        text_cache_compute_size(text, font, &width, &height);
+        ei_size_t size = ei_size(width, height);
+        ei_surface_t surface = hw_surface_create(atlas->format, size, EI_TRUE);
+
+        int red_place; int green_place;
+        int blue_place; int alpha_place;
+        hw_surface_get_channel_indices(surface, &red_place, &green_place, &blue_place, &alpha_place);
+        alpha_place = 6 - (blue_place + red_place + green_place);
+
+        // The background is the color of the text, fully transparent
+        hw_surface_lock(surface);
+        uint8_t *first_pixel = hw_surface_get_buffer(surface);
+        color.alpha = 0;
+        fill_span((uint32_t *) first_pixel, ei_map_rgba(surface, color), size.width * size.height);
+
+        // Copy the coverage of each glyph in the alpha channel. Kerned glyphs may overlap, the highest
+        // coverage is kept.
+        int32_t x = 0;
+        const char *previous_bytes = NULL;
+        glyph *previous_glyph = NULL;
+        for (const char *current = text ; *current != '\0' ; ) {
+                const char *bytes = current;
+                glyph *current_glyph = next_glyph(atlas, &current);
+                if (previous_glyph) {
+                        x += previous_glyph->advance
+                             + pair_kerning(atlas, previous_bytes, previous_glyph, current_glyph, (int) (current - previous_bytes));
+                }
+                previous_bytes = bytes;
+                previous_glyph = current_glyph;
+
+                // Only the columns of the glyph which are in the surface are copied
+                int32_t begin = x < 0 ? -x : 0;
+                int32_t end = x + current_glyph->advance < size.width ? current_glyph->advance : size.width - x;
+                int32_t height = current_glyph->height < size.height ? current_glyph->height : size.height;
+
+                for (int32_t y = 0 ; y < height ; ++y) {
+                        const uint8_t *coverage = atlas->coverage + (current_glyph->y + y) * atlas->size.width + current_glyph->x;
+                        uint8_t *pixel = first_pixel + 4 * (y * size.width + x + begin) + alpha_place;
+                        for (int32_t i = begin ; i < end ; ++i, pixel += 4) {
+                                *pixel = coverage[i] > *pixel ? coverage[i] : *pixel;
+                        }
+                }
+        }
+        hw_surface_unlock(surface);
+
+        return surface;
+}
+
+/**
+ * @brief       Free an atlas and its glyphs.
+ *
+ * @param       atlas       The atlas, it must not be in the list of the atlases anymore
+ */
+static void free_atlas(glyph_atlas *atlas) {
+        for (int i = 0 ; i < 128 ; ++i) {
+                free(atlas->ascii[i]);
+        }
+        while (atlas->others != NULL) {
+                glyph *to_suppr = atlas->others;
+                atlas->others = to_suppr->next;
+                free(to_suppr);
+        }
+
+        if (atlas->format) hw_surface_free(atlas->format);
+        free(atlas->coverage);
+        free(atlas->kerning);
+        free(atlas);
+}
+
+/**
+ * @brief       Free the atlas of a font. It must be called before the font is freed, because a font created
+ *              later may have the same address.
+ *
+ * @param       font        The font, it may have no atlas.
+ */
+void glyph_atlas_forget(ei_font_t font) {
+        for (glyph_atlas **link = &g_atlases ; *link != NULL ; link = &(*link)->next) {
+                if ((*link)->font == font) {
+                        glyph_atlas *atlas = *link;
+                        *link = atlas->next;
+                        free_atlas(atlas);
+                        return;
+                }
+        }
+}
+
+/**
+ * @brief       Free the atlases of all the fonts. It must be called before a font which has been used is freed.
+ */
+void glyph_atlas_release(void) {
+        while (g_atlases != NULL) {
+                glyph_atlas *atlas = g_atlases;
+                g_atlases = atlas->next;
+                free_atlas(atlas);
+        }
+}
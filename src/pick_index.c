@@ -0,0 +1,334 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "pick_index.h"
+#include "ei_application.h"
+#include "ei_utils.h"
+#include "widget_manager.h"
+#include "ei_create_button.h"
+#include "class_registry.h"
+
+/**
+ * @brief       The widgets whose pick rectangle intersects a cell of the spatial index.
+ */
+typedef struct pick_cell {
+        ei_widget_t**   widgets;        ///< The widgets, in no particular order
+        uint32_t        nb_widgets;     ///< Number of widgets in the cell
+        uint32_t        size;           ///< Number of widgets which can be stored in widgets
+} pick_cell;
+
+// Uniform grid covering the root window, allocated on first use
+static pick_cell *g_cells = NULL;
+static int32_t g_nb_columns = 0;
+static int32_t g_nb_rows = 0;
+
+/**
+ * @brief       Compute the part of a widget which is drawn in the picking offscreen.
+ *
+ * @param       widget      The widget
+ * @param       rect        Where to write the rectangle of the part
+ * @param       radius      Where to write the radius of its rounded corners, 0 if they are straight
+ */
+static void pick_shape(ei_widget_t *widget, ei_rect_t *rect, int *radius) {
+        *rect = widget->screen_location;
+        *radius = 0;
+
+        // Buttons and frames are picked only inside their border
+        int border_width = 0;
+        if (widget->wclass->id == CLASS_ID_BUTTON) {
+                border_width = ((ei_button_t *) widget)->border_width;
+                *radius = ((ei_button_t *) widget)->corner_radius;
+        } else if (widget->wclass->id == CLASS_ID_FRAME) {
+                border_width = ((ei_frame_t *) widget)->border_width;
+        }
+
+        rect->top_left.x += border_width;
+        rect->top_left.y += border_width;
+        rect->size.width -= 2 * border_width;
+        rect->size.height -= 2 * border_width;
+}
+
+/**
+ * @brief       Compute the range of cells covered by a rectangle.
+ *
+ * @param       rect        The rectangle
+ * @param       first       Where to write the column and the row of the first cell
+ * @param       last        Where to write the column and the row of the last cell, included
+ *
+ * @return      EI_FALSE if the rectangle covers no cell.
+ */
+static ei_bool_t cell_range(ei_rect_t rect, ei_point_t *first, ei_point_t *last) {
+        if (ei_rect_is_empty(rect)) return EI_FALSE;
+
+        first->x = rect.top_left.x < 0 ? 0 : rect.top_left.x / PICK_INDEX_CELL_SIZE;
+        first->y = rect.top_left.y < 0 ? 0 : rect.top_left.y / PICK_INDEX_CELL_SIZE;
+        last->x = (rect.top_left.x + rect.size.width - 1) / PICK_INDEX_CELL_SIZE;
+        last->y = (rect.top_left.y + rect.size.height - 1) / PICK_INDEX_CELL_SIZE;
+        last->x = last->x < g_nb_columns ? last->x : g_nb_columns - 1;
+        last->y = last->y < g_nb_rows ? last->y : g_nb_rows - 1;
+
+        return first->x <= last->x && first->y <= last->y;
+}
+
+/**
+ * @brief       Remove a widget from the spatial index. It does nothing if the widget is not indexed.
+ *
+ * @param       widget      The widget
+ */
+void pick_index_remove(ei_widget_t *widget) {
+        ei_point_t first, last;
+        if (g_cells && cell_range(widget->pick_rect, &first, &last)) {
+                for (int32_t row = first.y ; row <= last.y ; ++row) {
+                        for (int32_t column = first.x ; column <= last.x ; ++column) {
+                                pick_cell *cell = &g_cells[row * g_nb_columns + column];
+
+                                // The order of the widgets in a cell doesn't matter, the last one takes its place
+                                for (uint32_t i = 0 ; i < cell->nb_widgets ; ++i) {
+                                        if (cell->widgets[i] == widget) {
+                                                cell->widgets[i] = cell->widgets[--cell->nb_widgets];
+                                                break;
+                                        }
+                                }
+                        }
+                }
+        }
+
+        widget->pick_rect = ei_rect_zero();
+        widget->pick_radius = 0;
+}
+
+/**
+ * @brief       Add a widget to the cells covered by its pick rectangle.
+ *
+ * @param       widget      The widget, it must not be in the cells yet
+ */
+static void add_to_cells(ei_widget_t *widget) {
+        ei_point_t first, last;
+        if (!cell_range(widget->pick_rect, &first, &last)) return;
+
+        for (int32_t row = first.y ; row <= last.y ; ++row) {
+                for (int32_t column = first.x ; column <= last.x ; ++column) {
+                        pick_cell *cell = &g_cells[row * g_nb_columns + column];
+                        if (cell->nb_widgets == cell->size) {
+                                cell->size = cell->size ? cell->size * 2 : 4;
+                                cell->widgets = realloc(cell->widgets, cell->size * sizeof(ei_widget_t*));
+                        }
+                        cell->widgets[cell->nb_widgets++] = widget;
+                }
+        }
+}
+
+/**
+ * @brief       Compute the part of a widget which can be picked, and store it in the spatial index.
+ *              It must be called each time the location, the size or the border of the widget changes.
+ *              The root widget and the widgets which are not managed by the placer are not indexed.
+ *
+ * @param       widget      The widget
+ */
+void pick_index_update(ei_widget_t *widget) {
+        pick_index_remove(widget);
+        if (widget->parent == NULL || widget->placer_params == NULL) return;
+
+        // The grid covers the root window
+        if (g_cells == NULL) {
+                ei_size_t root_size = hw_surface_get_size(ei_app_root_surface());
+                g_nb_columns = (root_size.width + PICK_INDEX_CELL_SIZE - 1) / PICK_INDEX_CELL_SIZE;
+                g_nb_rows = (root_size.height + PICK_INDEX_CELL_SIZE - 1) / PICK_INDEX_CELL_SIZE;
+                g_cells = calloc(g_nb_columns * g_nb_rows, sizeof(pick_cell));
+        }
+
+        pick_shape(widget, &widget->pick_rect, &widget->pick_radius);
+        add_to_cells(widget);
+}
+
+/**
+ * @brief       Move the indexed part of a widget whose location has been translated, without computing
+ *              its shape again. It does nothing if the widget is not indexed.
+ *
+ * @param       widget      The widget
+ * @param       shift       The translation
+ */
+void pick_index_translate(ei_widget_t *widget, ei_point_t shift) {
+        if (ei_rect_is_empty(widget->pick_rect)) return;
+
+        ei_rect_t rect = widget->pick_rect;
+        int radius = widget->pick_radius;
+        pick_index_remove(widget);
+
+        rect.top_left.x += shift.x;
+        rect.top_left.y += shift.y;
+        widget->pick_rect = rect;
+        widget->pick_radius = radius;
+        add_to_cells(widget);
+}
+
+/**
+ * @brief       Test if a point is in a rectangle.
+ *
+ * @param       where       The point
+ * @param       rect        The rectangle
+ *
+ * @return      EI_TRUE if the point is inside.
+ */
+static ei_bool_t is_in_rect(ei_point_t where, ei_rect_t rect) {
+        return where.x >= rect.top_left.x && where.x < rect.top_left.x + rect.size.width
+               && where.y >= rect.top_left.y && where.y < rect.top_left.y + rect.size.height;
+}
+
+/**
+ * @brief       Test if a pixel is filled when a polygon is drawn by \ref ei_draw_polygon_n. The same
+ *              rules are used: a side covers the scanlines from its top included to its bottom excluded,
+ *              its abscissa is rounded down, and each span is filled from its left side included to its
+ *              right side excluded. So the pixel is filled if an odd number of sides are on its left.
+ *
+ * @param       where       The pixel
+ * @param       points      The points of the polygon, the last one is linked to the first one
+ * @param       nb_points   Number of points
+ *
+ * @return      EI_TRUE if the pixel is filled.
+ */
+static ei_bool_t is_in_polygon(ei_point_t where, const ei_point_t *points, uint32_t nb_points) {
+        ei_bool_t is_inside = EI_FALSE;
+        for (uint32_t i = 0 ; i < nb_points ; ++i) {
+                ei_point_t p1 = points[i];
+                ei_point_t p2 = i + 1 < nb_points ? points[i + 1] : points[0];
+                if (p1.y > p2.y) {
+                        ei_point_t tmp = p1;
+                        p1 = p2;
+                        p2 = tmp;
+                }
+                if (where.y < p1.y || where.y >= p2.y) continue;
+
+                // Abscissa of the side on the scanline of the pixel, rounded down
+                int64_t x_move = (int64_t) (p2.x - p1.x) * (where.y - p1.y);
+                int64_t dy = p2.y - p1.y;
+                int64_t x_offset = x_move / dy - (x_move % dy < 0);
+                if (p1.x + x_offset <= where.x) {
+                        is_inside = !is_inside;
+                }
+        }
+        return is_inside;
+}
+
+/**
+ * @brief       Test if a point is in the indexed shape of a widget. The rounded corners are tested
+ *              with the polygon drawn in the picking offscreen, so both pick modes agree.
+ *
+ * @param       widget      The widget
+ * @param       where       The point
+ *
+ * @return      EI_TRUE if the point is inside.
+ */
+static ei_bool_t is_in_shape(ei_widget_t *widget, ei_point_t where) {
+        if (!is_in_rect(where, widget->pick_rect)) return EI_FALSE;
+        if (widget->pick_radius <= 0) return EI_TRUE;
+
+        ei_point_t points[ROUNDED_FRAME_MAX_POINTS];
+        uint32_t nb_points = rounded_frame_cached(widget->pick_rect, widget->pick_radius, FULL, points);
+        return is_in_polygon(where, points, nb_points);
+}
+
+/**
+ * @brief       Test if a point is visible in a widget, i.e. in the content rect of all its ancestors,
+ *              which must all be managed by the placer.
+ *
+ * @param       widget      The widget
+ * @param       where       The point
+ *
+ * @return      EI_TRUE if the point is visible.
+ */
+static ei_bool_t is_visible(ei_widget_t *widget, ei_point_t where) {
+        for (ei_widget_t *ancestor = widget->parent ; ancestor != NULL ; ancestor = ancestor->parent) {
+                if (ancestor->parent && ancestor->placer_params == NULL) return EI_FALSE;
+                if (!is_in_rect(where, *ancestor->content_rect)) return EI_FALSE;
+        }
+        return EI_TRUE;
+}
+
+/**
+ * @brief       Return the depth of a widget in the hierarchy, 0 for the root widget.
+ */
+static uint32_t depth(ei_widget_t *widget) {
+        uint32_t depth = 0;
+        for ( ; widget->parent != NULL ; widget = widget->parent) {
+                ++depth;
+        }
+        return depth;
+}
+
+/**
+ * @brief       Test if a widget is drawn after another one, i.e. it is in front of it. Only the ancestors
+ *              of both widgets are visited, the siblings are ordered by their stacking keys.
+ *
+ * @param       widget      The widget
+ * @param       other       The other widget, different from widget
+ *
+ * @return      EI_TRUE if widget is in front of other.
+ */
+static ei_bool_t is_in_front(ei_widget_t *widget, ei_widget_t *other) {
+        uint32_t widget_depth = depth(widget);
+        uint32_t other_depth = depth(other);
+
+        // Bring both widgets to the same depth, a widget is in front of its ancestors
+        ei_widget_t *widget_branch = widget;
+        ei_widget_t *other_branch = other;
+        while (widget_depth > other_depth) {
+                widget_branch = widget_branch->parent;
+                --widget_depth;
+        }
+        while (other_depth > widget_depth) {
+                other_branch = other_branch->parent;
+                --other_depth;
+        }
+        if (widget_branch == other_branch) return widget != widget_branch;
+
+        // Siblings are drawn in the order of their stacking keys
+        while (widget_branch->parent != other_branch->parent) {
+                widget_branch = widget_branch->parent;
+                other_branch = other_branch->parent;
+        }
+        return widget_branch->stacking_key > other_branch->stacking_key;
+}
+
+/**
+ * @brief       Return the top-most indexed widget at a location, without using the picking offscreen.
+ *              Rounded corners of buttons are tested exactly, and widgets are clipped by the content
+ *              rect of their ancestors as when they are drawn.
+ *
+ * @param       where       The location, expressed in the root window coordinates.
+ *
+ * @return      The widget, or NULL if only the root widget is at this location.
+ */
+ei_widget_t *pick_index_find(ei_point_t where) {
+        if (g_cells == NULL || where.x < 0 || where.y < 0) return NULL;
+
+        int32_t column = where.x / PICK_INDEX_CELL_SIZE;
+        int32_t row = where.y / PICK_INDEX_CELL_SIZE;
+        if (column >= g_nb_columns || row >= g_nb_rows) return NULL;
+
+        // Only the widgets of the cell are tested, the front-most one is kept
+        pick_cell *cell = &g_cells[row * g_nb_columns + column];
+        ei_widget_t *picked = NULL;
+        for (uint32_t i = 0 ; i < cell->nb_widgets ; ++i) {
+                ei_widget_t *widget = cell->widgets[i];
+                if (!is_in_shape(widget, where)) continue;
+                if (picked && !is_in_front(widget, picked)) continue;
+                if (is_visible(widget, where)) picked = widget;
+        }
+        return picked;
+}
+
+/**
+ * @brief       Free the memory used by the spatial index.
+ */
+void pick_index_release(void) {
+        if (g_cells == NULL) return;
+
+        for (int32_t i = 0 ; i < g_nb_columns * g_nb_rows ; ++i) {
+                free(g_cells[i].widgets);
+        }
+        free(g_cells);
+        g_cells = NULL;
+        g_nb_columns = 0;
+        g_nb_rows = 0;
+}
@@ -0,0 +1,317 @@
+#include <string.h>
+
+#include "pixel_kernels.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define PIXEL_KERNELS_SSE2
+#endif
+
+#if defined(PIXEL_KERNELS_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define PIXEL_KERNELS_AVX2
+#endif
+
+/*
+ * Scalar kernels, always available
+ */
+
+/**
+ * @brief       Write the same color on consecutive pixels, one pixel at a time.
+ */
+static void fill_span_scalar(uint32_t *dst, uint32_t color, int32_t count) {
+        for (int32_t i = 0 ; i < count ; ++i) {
+                dst[i] = color;
+        }
+}
+
+/**
+ * @brief       Return (src * alpha + dst * (255 - alpha) + 127) / 255 without division.
+ */
+static inline uint8_t blend_channel(uint8_t src, uint8_t dst, uint8_t alpha) {
+        uint32_t value = src * alpha + dst * (255 - alpha) + 128;
+        return (uint8_t) ((value + (value >> 8)) >> 8);
+}
+
+/**
+ * @brief       Blend source pixels on destination pixels one pixel at a time, runs of opaque pixels are copied.
+ */
+static void blend_span_scalar(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place) {
+        int32_t i = 0;
+        while (i < count) {
+                const uint8_t *src_pixel = (const uint8_t *) &src[i];
+                uint8_t alpha = src_pixel[alpha_place];
+
+                if (alpha == 0) {
+                        // Transparent pixel, only the destination becomes opaque, unless it is transparent too
+                        uint8_t *dst_pixel = (uint8_t *) &dst[i];
+                        if (dst_pixel[alpha_place] != 0) dst_pixel[alpha_place] = 255;
+                        ++i;
+                } else if (alpha == 255) {
+                        // Copy the whole run of opaque pixels
+                        int32_t end = i + 1;
+                        while (end < count && ((const uint8_t *) &src[end])[alpha_place] == 255) {
+                                ++end;
+                        }
+                        memcpy(&dst[i], &src[i], (end - i) * sizeof(uint32_t));
+                        i = end;
+                } else {
+                        uint8_t *dst_pixel = (uint8_t *) &dst[i];
+                        for (int channel = 0 ; channel < 4 ; ++channel) {
+                                dst_pixel[channel] = blend_channel(src_pixel[channel], dst_pixel[channel], alpha);
+                        }
+                        dst_pixel[alpha_place] = 255;
+                        ++i;
+                }
+        }
+}
+
+/*
+ * SSE2 kernels, 4 pixels at a time
+ */
+
+#ifdef PIXEL_KERNELS_SSE2
+/**
+ * @brief       Write the same color on consecutive pixels, 4 pixels at a time with aligned stores.
+ */
+static void fill_span_sse2(uint32_t *dst, uint32_t color, int32_t count) {
+        // Reach a 16 bytes boundary
+        while (count > 0 && ((uintptr_t) dst & 15)) {
+                *dst++ = color;
+                --count;
+        }
+
+        __m128i colors = _mm_set1_epi32((int) color);
+        for ( ; count >= 4 ; count -= 4, dst += 4) {
+                _mm_store_si128((__m128i *) dst, colors);
+        }
+
+        // Last pixels
+        fill_span_scalar(dst, color, count);
+}
+
+/**
+ * @brief       Blend the 16 bits channels of 2 pixels, see \ref blend_channel.
+ */
+static inline __m128i blend_channels_sse2(__m128i src, __m128i dst, __m128i alpha) {
+        __m128i value = _mm_add_epi16(_mm_mullo_epi16(src, alpha),
+                                      _mm_mullo_epi16(dst, _mm_sub_epi16(_mm_set1_epi16(255), alpha)));
+        value = _mm_add_epi16(value, _mm_set1_epi16(128));
+        return _mm_srli_epi16(_mm_add_epi16(value, _mm_srli_epi16(value, 8)), 8);
+}
+
+/**
+ * @brief       Blend source pixels on destination pixels, 4 pixels at a time.
+ */
+static void blend_span_sse2(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place) {
+        __m128i zero = _mm_setzero_si128();
+        __m128i alpha_mask = _mm_set1_epi32((int) (0xFFu << (8 * alpha_place)));
+        __m128i alpha_shift = _mm_cvtsi32_si128(8 * alpha_place);
+
+        for ( ; count >= 4 ; count -= 4, dst += 4, src += 4) {
+                __m128i src_pixels = _mm_loadu_si128((const __m128i *) src);
+                __m128i alphas = _mm_and_si128(src_pixels, alpha_mask);
+
+                // Fully opaque pixels are copied
+                if (_mm_movemask_epi8(_mm_cmpeq_epi32(alphas, alpha_mask)) == 0xFFFF) {
+                        _mm_storeu_si128((__m128i *) dst, src_pixels);
+                        continue;
+                }
+
+                // The alpha channel becomes opaque, except for transparent pixels on transparent pixels
+                __m128i dst_pixels = _mm_loadu_si128((const __m128i *) dst);
+                __m128i transparent = _mm_cmpeq_epi32(alphas, zero);
+                __m128i kept = _mm_and_si128(transparent, _mm_cmpeq_epi32(_mm_and_si128(dst_pixels, alpha_mask), zero));
+                __m128i opaque = _mm_andnot_si128(kept, alpha_mask);
+
+                // Fully transparent pixels are not blended
+                if (_mm_movemask_epi8(transparent) == 0xFFFF) {
+                        _mm_storeu_si128((__m128i *) dst, _mm_or_si128(dst_pixels, opaque));
+                        continue;
+                }
+
+                // Alpha of each pixel, repeated in the four 16 bits channels of the pixel
+                alphas = _mm_srl_epi32(alphas, alpha_shift);
+                alphas = _mm_or_si128(alphas, _mm_slli_epi32(alphas, 16));
+
+                __m128i low = blend_channels_sse2(_mm_unpacklo_epi8(src_pixels, zero),
+                                                  _mm_unpacklo_epi8(dst_pixels, zero),
+                                                  _mm_unpacklo_epi32(alphas, alphas));
+                __m128i high = blend_channels_sse2(_mm_unpackhi_epi8(src_pixels, zero),
+                                                   _mm_unpackhi_epi8(dst_pixels, zero),
+                                                   _mm_unpackhi_epi32(alphas, alphas));
+
+                // The blend keeps the channels of the transparent pixels
+                _mm_storeu_si128((__m128i *) dst, _mm_or_si128(_mm_packus_epi16(low, high), opaque));
+        }
+
+        // Last pixels
+        blend_span_scalar(dst, src, count, alpha_place);
+}
+#endif
+
+/*
+ * AVX2 kernels, 8 pixels at a time
+ */
+
+#ifdef PIXEL_KERNELS_AVX2
+/**
+ * @brief       Write the same color on consecutive pixels, 8 pixels at a time with aligned stores.
+ */
+__attribute__((target("avx2")))
+static void fill_span_avx2(uint32_t *dst, uint32_t color, int32_t count) {
+        // Reach a 32 bytes boundary
+        while (count > 0 && ((uintptr_t) dst & 31)) {
+                *dst++ = color;
+                --count;
+        }
+
+        __m256i colors = _mm256_set1_epi32((int) color);
+        for ( ; count >= 16 ; count -= 16, dst += 16) {
+                _mm256_store_si256((__m256i *) dst, colors);
+                _mm256_store_si256((__m256i *) (dst + 8), colors);
+        }
+        for ( ; count >= 8 ; count -= 8, dst += 8) {
+                _mm256_store_si256((__m256i *) dst, colors);
+        }
+
+        // Last pixels
+        fill_span_scalar(dst, color, count);
+}
+
+/**
+ * @brief       Blend the 16 bits channels of 4 pixels, see \ref blend_channel.
+ */
+__attribute__((target("avx2")))
+static inline __m256i blend_channels_avx2(__m256i src, __m256i dst, __m256i alpha) {
+        __m256i value = _mm256_add_epi16(_mm256_mullo_epi16(src, alpha),
+                                         _mm256_mullo_epi16(dst, _mm256_sub_epi16(_mm256_set1_epi16(255), alpha)));
+        value = _mm256_add_epi16(value, _mm256_set1_epi16(128));
+        return _mm256_srli_epi16(_mm256_add_epi16(value, _mm256_srli_epi16(value, 8)), 8);
+}
+
+/**
+ * @brief       Blend source pixels on destination pixels, 8 pixels at a time.
+ */
+__attribute__((target("avx2")))
+static void blend_span_avx2(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place) {
+        __m256i zero = _mm256_setzero_si256();
+        __m256i alpha_mask = _mm256_set1_epi32((int) (0xFFu << (8 * alpha_place)));
+        __m128i alpha_shift = _mm_cvtsi32_si128(8 * alpha_place);
+
+        for ( ; count >= 8 ; count -= 8, dst += 8, src += 8) {
+                __m256i src_pixels = _mm256_loadu_si256((const __m256i *) src);
+                __m256i alphas = _mm256_and_si256(src_pixels, alpha_mask);
+
+                // Fully opaque pixels are copied
+                if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(alphas, alpha_mask)) == -1) {
+                        _mm256_storeu_si256((__m256i *) dst, src_pixels);
+                        continue;
+                }
+
+                // The alpha channel becomes opaque, except for transparent pixels on transparent pixels
+                __m256i dst_pixels = _mm256_loadu_si256((const __m256i *) dst);
+                __m256i transparent = _mm256_cmpeq_epi32(alphas, zero);
+                __m256i kept = _mm256_and_si256(transparent,
+                                                _mm256_cmpeq_epi32(_mm256_and_si256(dst_pixels, alpha_mask), zero));
+                __m256i opaque = _mm256_andnot_si256(kept, alpha_mask);
+
+                // Fully transparent pixels are not blended
+                if (_mm256_movemask_epi8(transparent) == -1) {
+                        _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(dst_pixels, opaque));
+                        continue;
+                }
+
+                // Alpha of each pixel, repeated in the four 16 bits channels of the pixel
+                alphas = _mm256_srl_epi32(alphas, alpha_shift);
+                alphas = _mm256_or_si256(alphas, _mm256_slli_epi32(alphas, 16));
+
+                // Unpacks and packs work inside each 128 bits lane, so the order of the pixels is kept
+                __m256i low = blend_channels_avx2(_mm256_unpacklo_epi8(src_pixels, zero),
+                                                  _mm256_unpacklo_epi8(dst_pixels, zero),
+                                                  _mm256_unpacklo_epi32(alphas, alphas));
+                __m256i high = blend_channels_avx2(_mm256_unpackhi_epi8(src_pixels, zero),
+                                                   _mm256_unpackhi_epi8(dst_pixels, zero),
+                                                   _mm256_unpackhi_epi32(alphas, alphas));
+
+                // The blend keeps the channels of the transparent pixels
+                _mm256_storeu_si256((__m256i *) dst, _mm256_or_si256(_mm256_packus_epi16(low, high), opaque));
+        }
+
+        // Last pixels
+        blend_span_sse2(dst, src, count, alpha_place);
+}
+#endif
+
+/*
+ * Selection of the kernels
+ */
+
+static void fill_span_select(uint32_t *dst, uint32_t color, int32_t count);
+static void blend_span_select(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place);
+
+// Kernels used by the library. At first, they point on the selection functions.
+static void (*g_fill_span)(uint32_t *, uint32_t, int32_t) = fill_span_select;
+static void (*g_blend_span)(uint32_t *, const uint32_t *, int32_t, int) = blend_span_select;
+
+/**
+ * @brief       Choose the best kernels for the CPU which runs the program.
+ */
+static void select_kernels(void) {
+        g_fill_span = fill_span_scalar;
+        g_blend_span = blend_span_scalar;
+
+#ifdef PIXEL_KERNELS_SSE2
+        g_fill_span = fill_span_sse2;
+        g_blend_span = blend_span_sse2;
+#endif
+
+#ifdef PIXEL_KERNELS_AVX2
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+                g_fill_span = fill_span_avx2;
+                g_blend_span = blend_span_avx2;
+        }
+#endif
+}
+
+/**
+ * @brief       Select the kernels on the first call, then write the pixels.
+ */
+static void fill_span_select(uint32_t *dst, uint32_t color, int32_t count) {
+        select_kernels();
+        g_fill_span(dst, color, count);
+}
+
+/**
+ * @brief       Select the kernels on the first call, then blend the pixels.
+ */
+static void blend_span_select(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place) {
+        select_kernels();
+        g_blend_span(dst, src, count, alpha_place);
+}
+
+/**
+ * @brief       Write the same 32 bits color on consecutive pixels.
+ *
+ * @param       dst         The first pixel to write
+ * @param       color       The color, already mapped with ei_map_rgba
+ * @param       count       The number of pixels to write. Nothing is done if it is not positive.
+ */
+void fill_span(uint32_t *dst, uint32_t color, int32_t count) {
+        if (count > 0) g_fill_span(dst, color, count);
+}
+
+/**
+ * @brief       Blend consecutive source pixels on destination pixels, weighted by the alpha channel of the source.
+ *              Each color channel is rounded: (src * alpha + dst * (255 - alpha) + 127) / 255, and the alpha
+ *              channel of the destination becomes 255. Fully transparent source pixels are skipped.
+ *
+ * @param       dst         The first destination pixel
+ * @param       src         The first source pixel, the channels must be in the same order than in dst
+ * @param       count       The number of pixels to blend. Nothing is done if it is not positive.
+ * @param       alpha_place The index of the alpha channel in a pixel, as given by hw_surface_get_channel_indices
+ */
+void blend_span(uint32_t *dst, const uint32_t *src, int32_t count, int alpha_place) {
+        if (count > 0) g_blend_span(dst, src, count, alpha_place);
+}
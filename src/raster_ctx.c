@@ -0,0 +1,73 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "raster_ctx.h"
+
+// The context shared by all drawing functions
+static ei_raster_ctx g_raster_ctx = {NULL, 0, 0, NULL, 0, NULL, 0};
+
+/**
+ * @brief       Return the rasterizer context shared by all drawing functions.
+ *
+ * @return      The context. It must not be freed by the user, see \ref raster_ctx_release.
+ */
+ei_raster_ctx *raster_ctx_get(void) {
+        return &g_raster_ctx;
+}
+
+/**
+ * @brief       Prepare the context for a new polygon: the sides of the previous one are discarded,
+ *              the pool and the edge table grow if they are too small.
+ *
+ * @param       ctx         The context
+ * @param       nb_sides    The maximum number of sides of the polygon
+ * @param       nb_lines    The number of scanlines of the polygon. All the buckets are emptied.
+ */
+void raster_ctx_reset(ei_raster_ctx *ctx, uint32_t nb_sides, uint32_t nb_lines) {
+        // Grow the pool, at least twice bigger to avoid reallocating for each slightly bigger polygon
+        if (nb_sides > ctx->pool_size) {
+                uint32_t new_size = ctx->pool_size * 2 > nb_sides ? ctx->pool_size * 2 : nb_sides;
+                free(ctx->pool);
+                ctx->pool = malloc(new_size * sizeof(side));
+                ctx->pool_size = new_size;
+        }
+        ctx->nb_sides = 0;
+
+        // Grow the edge table
+        if (nb_lines > ctx->tc_size) {
+                uint32_t new_size = ctx->tc_size * 2 > nb_lines ? ctx->tc_size * 2 : nb_lines;
+                free(ctx->tc);
+                ctx->tc = malloc(new_size * sizeof(side*));
+                ctx->tc_size = new_size;
+        }
+        memset(ctx->tc, 0, nb_lines * sizeof(side*));
+}
+
+/**
+ * @brief       Return the point buffer of the context, it grows if it is too small.
+ *              Its content is not kept when it grows.
+ *
+ * @param       ctx         The context
+ * @param       nb_points   The number of points which must be stored.
+ *
+ * @return      The buffer, owned by the context.
+ */
+ei_point_t *raster_ctx_points(ei_raster_ctx *ctx, uint32_t nb_points) {
+        if (nb_points > ctx->points_size) {
+                uint32_t new_size = ctx->points_size * 2 > nb_points ? ctx->points_size * 2 : nb_points;
+                free(ctx->points);
+                ctx->points = malloc(new_size * sizeof(ei_point_t));
+                ctx->points_size = new_size;
+        }
+        return ctx->points;
+}
+
+/**
+ * @brief       Free the memory used by the shared context.
+ */
+void raster_ctx_release(void) {
+        free(g_raster_ctx.pool);
+        free(g_raster_ctx.tc);
+        free(g_raster_ctx.points);
+        g_raster_ctx = (ei_raster_ctx) {NULL, 0, 0, NULL, 0, NULL, 0};
+}
@@ -0,0 +1,127 @@
+#include <stdlib.h>
+
+#include "render_cache.h"
+#include "ei_application.h"
+#include "ei_utils.h"
+
+/**
+ * @brief       Value of the pixels of the cache which the subtree has not drawn. The draw functions write
+ *              the colors of the widgets without blending them, so a translucent widget gives translucent
+ *              pixels which must overwrite the window as they are, like when the subtree is not cached.
+ *              Only the pixels which still have this value show what is behind the widget. Its alpha channel
+ *              is 0, so the fully transparent pixels of a blended image, around the characters of a text for
+ *              example, leave it unchanged.
+ */
+static const ei_color_t g_untouched_color = {0x01, 0x02, 0x03, 0x00};
+
+/**
+ * @brief       Allocate an empty cache, which must be rendered before being copied.
+ *
+ * @return      The cache, it must be freed by \ref render_cache_free.
+ */
+ei_render_cache_t *render_cache_create(void) {
+        return calloc(1, sizeof(ei_render_cache_t));
+}
+
+/**
+ * @brief       Free a cache and its surface.
+ *
+ * @param       cache       The cache, it can be NULL.
+ */
+void render_cache_free(ei_render_cache_t *cache) {
+        if (cache == NULL) return;
+
+        if (cache->surface) {
+                hw_surface_free(cache->surface);
+        }
+        free(cache);
+}
+
+/**
+ * @brief       Mark as outdated the caches of a widget and of all its ancestors, which all contain
+ *              the rendering of the widget.
+ *
+ * @param       widget      The widget which has changed, it can be NULL.
+ */
+void render_cache_invalidate(ei_widget_t *widget) {
+        for ( ; widget != NULL ; widget = widget->parent) {
+                if (widget->render_cache) {
+                        widget->render_cache->is_valid = EI_FALSE;
+                }
+        }
+}
+
+/**
+ * @brief       Prepare the cache of a widget to render its subtree again: the surface gets the size of
+ *              the widget and is cleared to a value which marks the untouched pixels. Its origin is the
+ *              top-left corner of the widget, so the subtree is drawn with the coordinates of the root window.
+ *              The cache is valid once this function returns.
+ *
+ * @param       widget      The widget, its render_cache field must not be NULL.
+ *
+ * @return      The surface where the subtree must be drawn.
+ */
+ei_surface_t render_cache_begin(ei_widget_t *widget) {
+        ei_render_cache_t *cache = widget->render_cache;
+        ei_size_t size = widget->screen_location.size;
+
+        // The surface is created again when the size of the widget has changed
+        if (cache->surface) {
+                ei_size_t cache_size = hw_surface_get_size(cache->surface);
+                if (cache_size.width != size.width || cache_size.height != size.height) {
+                        hw_surface_free(cache->surface);
+                        cache->surface = NULL;
+                }
+        }
+        if (cache->surface == NULL) {
+                cache->surface = hw_surface_create(ei_app_root_surface(), size, EI_TRUE);
+        }
+        hw_surface_set_origin(cache->surface, widget->screen_location.top_left);
+
+        // Pixels which are not covered by the subtree (rounded corners for example) show what is behind
+        ei_fill(cache->surface, &g_untouched_color, NULL);
+
+        cache->is_valid = EI_TRUE;
+        return cache->surface;
+}
+
+/**
+ * @brief       Copy the rendering of a widget on a surface, only the part inside the clipper.
+ *              The pixels drawn by the subtree replace the ones of the surface, exactly as if the subtree
+ *              was drawn on it. The pixels it has not drawn let the surface unchanged.
+ *
+ * @param       widget      The widget, its cache must have been rendered.
+ * @param       surface     Where to copy the rendering, in the root window coordinates.
+ * @param       clipper     The visible part of the widget.
+ */
+void render_cache_copy(ei_widget_t *widget, ei_surface_t surface, const ei_rect_t *clipper) {
+        ei_surface_t cache_surface = widget->render_cache->surface;
+
+        // The widget may have moved since its rendering
+        hw_surface_set_origin(cache_surface, widget->screen_location.top_left);
+
+        // Both surfaces use the coordinates of the root window, so the same rectangle is used for both
+        ei_rect_t rect = ei_rect_intersection(widget->screen_location, *clipper);
+        if (ei_rect_is_empty(rect)) return;
+
+        hw_surface_lock(cache_surface);
+        hw_surface_lock(surface);
+        uint32_t *src_line = (uint32_t *) hw_surface_get_buffer(cache_surface);
+        uint32_t *dst_line = (uint32_t *) hw_surface_get_buffer(surface);
+        int32_t src_width = hw_surface_get_size(cache_surface).width;
+        int32_t dst_width = hw_surface_get_size(surface).width;
+        uint32_t untouched = ei_map_rgba(cache_surface, g_untouched_color);
+
+        src_line += rect.top_left.y * src_width + rect.top_left.x;
+        dst_line += rect.top_left.y * dst_width + rect.top_left.x;
+        for (int32_t y = 0 ; y < rect.size.height ; ++y) {
+                for (int32_t x = 0 ; x < rect.size.width ; ++x) {
+                        if (src_line[x] != untouched) dst_line[x] = src_line[x];
+                }
+                src_line += src_width;
+                dst_line += dst_width;
+        }
+
+        hw_surface_unlock(surface);
+        hw_surface_unlock(cache_surface);
+}
@@ -1,204 +1,103 @@
 #include "single_linked_list.h"
 
 /**
- * @brief       Insert a new side on tail of single linked list.
- *
+ * @brief       Insert a new side in a linked list sorted by attribute xymin. The linked list stays sorted.
  *
  * @param       ll          The linked list
  * @param       new_side    The new side
 */
-void insert(side **ll, side *new_side) {
-        // Backup the head of linked list
-        side *first = *ll;
-
-        if (*ll != NULL) {
-                while ((*ll)->next != NULL) {
-                        *ll = (*ll)->next;
-                }
-                // Update the tail
-                (*ll)->next = new_side;
-                *ll = first;
-        } else {
-                // If linked list is empty, fill it with the created side
-                *ll = new_side;
+void insert_sorted(side **ll, side *new_side) {
+        // Find the place of the new side, after the sides with the same xymin
+        while (*ll != NULL && (*ll)->xymin <= new_side->xymin) {
+                ll = &(*ll)->next;
         }
+        new_side->next = *ll;
+        *ll = new_side;
 }
 
 /**
  * @brief       Delete each side where the attribute ymax is equal to ymax param.
+ *              Sides are only unlinked, their memory is owned by the rasterizer context.
  *
  * @param       ll          The linked list
  * @param       ymax        An integer
  */
 void delete(side **ll, int ymax) {
-        // Backup the head of linked list
-        side *first = *ll;
-
-        if (*ll != NULL) {
-                // Deletion of every node on head of linked list if they must be deleted
-                while ((*ll)->ymax == ymax) {
-                        side *to_suppr = *ll;
-                        *ll = (*ll)->next;
-                        free(to_suppr);
-                        if (*ll == NULL) return;
-                }
-
-                // Browse the linked list to delete every node if they must be deleted
-                while ((*ll)->next != NULL) {
-                        first = *ll;
-                        if (((*ll)->next)->ymax == ymax) {
-                                side *to_suppr = (*ll)->next;
-                                (*ll)->next = ((*ll)->next)->next;
-                                free(to_suppr);
-                        }
+        // Browse the linked list with the address of each link, so that the head is treated as other nodes
+        while (*ll != NULL) {
+                if ((*ll)->ymax == ymax) {
                         *ll = (*ll)->next;
+                } else {
+                        ll = &(*ll)->next;
                 }
-                *ll = first;
         }
 }
 
 /**
- * @@brief      Move each component of a source linked list on tail of destination linked list.
- *              At the end, the source linked list is empty.
+ * @brief       Merge a source linked list into a destination linked list, both sorted by attribute xymin.
+ *              At the end, the destination linked list is still sorted and the source linked list is empty.
  *
  * @param       ll1         The source linked list
  * @param       ll2         The destination linked list
  */
-void move(side **ll1, side **ll2) {
-        if (*ll1 != NULL) {
-                if (*ll2 != NULL) {
-                        // Get the tail of the destination linked list
-                        side *first_ll2 = *ll2;
-                        while ((*ll2)->next != NULL) {
-                                *ll2 = (*ll2)->next;
-                        }
+void merge(side **ll1, side **ll2) {
+        side *source = *ll1;
 
-                        // Insert the source linked list on tail of the destination linked list
-                        (*ll2)->next = *ll1;
-                        *ll2 = first_ll2;
-                } else {
-                        // If the destination linked list is empty, fill it with the source linked list
-                        *ll2 = *ll1;
+        while (source != NULL) {
+                // Skip the sides of the destination which are before the head of the source
+                while (*ll2 != NULL && (*ll2)->xymin <= source->xymin) {
+                        ll2 = &(*ll2)->next;
                 }
 
-                // Empty source linked list
-                *ll1 = NULL;
-        }
-}
-
-/**
- * @brief       Test if the array given in parameter is empty.
- *
- * @param       tc          The array
- * @param       size_tab    The size of tc array
- *
- * @return	A boolean: \ref EI_TRUE means that the array is empty,
- *		\ref EI_FALSE means it does not.
- */
-int is_empty (side **tc, uint32_t size_tab) {
-        for (uint32_t i = 0 ; i < size_tab ; ++i) {
-                if (tc[i] != NULL) {
-                        return EI_FALSE;
-                }
-        }
-        return EI_TRUE;
-}
-
-
-/**
- * @brief       Sort linked list by attribut xymin with an insertion sort.
- *
- * @param       tc      The linked list
- */
-void insertion_sort(side **tc) {
-        // Node current will point to head
-        side *current = *tc;
-
-        // Temporary variables to swap
-        side *index = NULL, *prec_current = NULL, *prec_index = NULL, *temp = NULL;
-
-        if (*tc != NULL) {
-                while (current != NULL) {
-                        // Backup previous node of index
-                        prec_index = current;
-                        //Node index will point to node next to current
-                        index = current->next;
-
-                        while (index != NULL) {
-                                //If current node's xymin is greater than index's node xymin, swap data between them
-                                if (current->xymin > index->xymin) {
-                                        // If we have to change the head of linked list
-                                        if (prec_current == NULL) {
-                                                temp = current->next;
-                                                current->next = index->next;
-                                                index->next = *tc;
-                                                *tc = index;
-                                        } else {
-                                                temp = index->next;
-                                                prec_current->next = index;
-                                                index->next = current->next;
-                                                prec_index->next = current;
-                                                current->next = temp;
-                                        }
-                                }
-                                // Update nodes
-                                prec_index = index;
-                                index = index->next;
-                        }
-                        // Update nodes
-                        prec_current = current;
-                        current = current->next;
-                }
+                // Link the head of the source here, the next one can't be placed before it
+                side *next = source->next;
+                source->next = *ll2;
+                *ll2 = source;
+                ll2 = &source->next;
+                source = next;
         }
-}
 
-/**
- * @brief       Return xymin attribute of the node placed in the position index of linked list.
- *
- * @param       tc      The linked list
- * @param       index   The place of concerned node in the linked list
- *
- * @return      An signed integer : the xymin attribute if the node placed in the position index of linked list exists,
- *              -1 if does not exist.
- */
-int32_t get_xymin(side *tc, uint32_t index) {
-        // Init the counter
-        uint32_t counter = 0;
-
-        while (tc != NULL) {
-                if (counter == index) {
-                        return tc->xymin;
-                }
-                ++counter;
-                tc = tc->next;
-        }
-        return -1;
+        // Empty source linked list
+        *ll1 = NULL;
 }
 
 /**
  * @brief       Update xymin (intersection point) of the linked list with Bresenham algorithm.
+ *              Sides which crossed each other are moved, so that the linked list stays sorted by attribute xymin.
+ *              As crossings are rare, it costs a single browse in most cases.
  *
  * @param       ll      The linked list
  */
 void set_xymin(side **ll) {
-        // Backup the head of linked list
-        side *first = *ll;
+        // Last side of the part of the linked list which is already updated and sorted
+        side *previous = NULL;
+        side **link = ll;
 
-        while (*ll != NULL) {
-                // Use Bresenham algorithm
-                (*ll)->error += abs((*ll)->dx);
-                uint32_t dx_signe = (*ll)->dx > 0 ? 1 : -1;
+        while (*link != NULL) {
+                side *current = *link;
+
+                // Move of the integer part of the inverse slope, then accumulate the error
+                current->xymin += current->x_step;
+                current->error += current->error_step;
 
-                if (2*(*ll)->error > abs((*ll)->dy)) {
-                        if (abs((*ll)->dx) > (*ll)->dy) {
-                                // Case near of horizontal
-                                (*ll)->xymin += (uint32_t) (*ll)->inv_slope;
-                        } else {
-                                (*ll)->xymin += dx_signe;
+                // The error is greater than one pixel
+                if (current->error >= current->dy) {
+                        ++current->xymin;
+                        current->error -= current->dy;
+                }
+
+                if (previous != NULL && current->xymin < previous->xymin) {
+                        // The side crossed a previous one: unlink it and insert it in the sorted part
+                        *link = current->next;
+                        side **place = ll;
+                        while ((*place)->xymin <= current->xymin) {
+                                place = &(*place)->next;
                         }
-                        (*ll)->error -= (*ll)->dy;
+                        current->next = *place;
+                        *place = current;
+                } else {
+                        previous = current;
+                        link = &current->next;
                 }
-                *ll = (*ll)->next;
         }
-        *ll = first;
 }
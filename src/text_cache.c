@@ -0,0 +1,386 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "text_cache.h"
+#include "glyph_atlas.h"
+
+/**
+ * @brief       A rendered text. It is both in a bucket of the hash table and in the LRU list.
+ */
+typedef struct text_entry {
+        char*                   text;           ///< Copy of the rendered string
+        ei_font_t               font;           ///< Font used to render the text
+        ei_color_t              color;          ///< Color used to render the text
+        uint32_t                hash;           ///< Hash of the key (text, font, color)
+
+        ei_surface_t            surface;        ///< The rendered text
+        size_t                  bytes;          ///< Memory used by the surface
+
+        struct text_entry*      next_in_bucket; ///< Next entry of the same bucket
+        struct text_entry*      more_recent;    ///< Previous entry in the LRU list
+        struct text_entry*      less_recent;    ///< Next entry in the LRU list
+} text_entry;
+
+/**
+ * @brief       The size of a text, stored in a bucket of the hash table of sizes.
+ */
+typedef struct size_entry {
+        char*                   text;           ///< Copy of the measured string
+        ei_font_t               font;           ///< Font used to measure the text
+        uint32_t                hash;           ///< Hash of the key (text, font)
+        ei_size_t               size;           ///< Size of the text surface
+        struct size_entry*      next;           ///< Next entry of the same bucket
+} size_entry;
+
+// Number of buckets of the hash table of sizes, a power of two
+#define TEXT_CACHE_SIZE_BUCKETS 1024
+
+// Hash table of the sizes, allocated on first use
+static size_entry **g_size_buckets = NULL;
+static uint32_t g_nb_sizes = 0;
+
+// Hash table of the entries, its size is a power of two
+static text_entry **g_buckets = NULL;
+static uint32_t g_nb_buckets = 0;
+
+// LRU list: the head is the most recently used entry, the tail is the next one to be evicted
+static text_entry *g_most_recent = NULL;
+static text_entry *g_least_recent = NULL;
+
+static size_t g_budget = TEXT_CACHE_DEFAULT_BUDGET;
+static text_cache_stats_t g_stats = {0, 0, 0, 0, 0, 0, 0};
+
+/**
+ * @brief       Hash the key of an entry with FNV-1a.
+ *
+ * @param       text        The string of the text
+ * @param       font        The font
+ * @param       color       The color
+ *
+ * @return      The hash.
+ */
+static uint32_t hash_key(const char *text, ei_font_t font, ei_color_t color) {
+        uint32_t hash = 2166136261u;
+        for (const unsigned char *c = (const unsigned char *) text ; *c != '\0' ; ++c) {
+                hash = (hash ^ *c) * 16777619u;
+        }
+
+        // Mix the font address and the color
+        uintptr_t font_bits = (uintptr_t) font;
+        hash = (hash ^ (uint32_t) (font_bits >> 4)) * 16777619u;
+        hash = (hash ^ (uint32_t) color.red) * 16777619u;
+        hash = (hash ^ (uint32_t) color.green) * 16777619u;
+        hash = (hash ^ (uint32_t) color.blue) * 16777619u;
+        hash = (hash ^ (uint32_t) color.alpha) * 16777619u;
+        return hash;
+}
+
+/**
+ * @brief       Unlink an entry from the LRU list.
+ *
+ * @param       entry       The entry
+ */
+static void lru_unlink(text_entry *entry) {
+        if (entry->more_recent) entry->more_recent->less_recent = entry->less_recent;
+        else g_most_recent = entry->less_recent;
+
+        if (entry->less_recent) entry->less_recent->more_recent = entry->more_recent;
+        else g_least_recent = entry->more_recent;
+}
+
+/**
+ * @brief       Put an entry on head of the LRU list.
+ *
+ * @param       entry       The entry, not in the LRU list
+ */
+static void lru_push_front(text_entry *entry) {
+        entry->more_recent = NULL;
+        entry->less_recent = g_most_recent;
+        if (g_most_recent) g_most_recent->more_recent = entry;
+        else g_least_recent = entry;
+        g_most_recent = entry;
+}
+
+/**
+ * @brief       Remove an entry from the cache and free it.
+ *
+ * @param       entry       The entry
+ */
+static void free_entry(text_entry *entry) {
+        // Unlink it from its bucket
+        text_entry **link = &g_buckets[entry->hash & (g_nb_buckets - 1)];
+        while (*link != entry) {
+                link = &(*link)->next_in_bucket;
+        }
+        *link = entry->next_in_bucket;
+        lru_unlink(entry);
+
+        g_stats.bytes -= entry->bytes;
+        --g_stats.entries;
+
+        hw_surface_free(entry->surface);
+        free(entry->text);
+        free(entry);
+}
+
+/**
+ * @brief       Free the least recently used entry.
+ */
+static void evict_least_recent(void) {
+        free_entry(g_least_recent);
+        ++g_stats.evictions;
+}
+
+/**
+ * @brief       Double the number of buckets, or create the hash table.
+ */
+static void grow_buckets(void) {
+        uint32_t new_nb_buckets = g_nb_buckets ? 2 * g_nb_buckets : 64;
+        text_entry **new_buckets = calloc(new_nb_buckets, sizeof(text_entry*));
+
+        for (uint32_t i = 0 ; i < g_nb_buckets ; ++i) {
+                text_entry *entry = g_buckets[i];
+                while (entry != NULL) {
+                        text_entry *next = entry->next_in_bucket;
+                        text_entry **bucket = &new_buckets[entry->hash & (new_nb_buckets - 1)];
+                        entry->next_in_bucket = *bucket;
+                        *bucket = entry;
+                        entry = next;
+                }
+        }
+
+        free(g_buckets);
+        g_buckets = new_buckets;
+        g_nb_buckets = new_nb_buckets;
+}
+
+/**
+ * @brief       Return the surface of a text rendered with a font and a color. The surface is composed
+ *              from the glyph atlas of the font only if it is not already in the cache.
+ *              The least recently used surfaces are freed when the budget is exceeded.
+ *
+ * @param       text        The string of the text. Can't be NULL.
+ * @param       font        The font used to render the text. Can't be NULL.
+ * @param       color       The text color.
+ *
+ * @return      The surface, owned by the cache. It stays valid until the next call to this function.
+ */
+ei_surface_t text_cache_get(const char *text, ei_font_t font, ei_color_t color) {
+        uint32_t hash = hash_key(text, font, color);
+
+        // Search the entry in its bucket
+        if (g_nb_buckets) {
+                for (text_entry *entry = g_buckets[hash & (g_nb_buckets - 1)] ; entry != NULL ; entry = entry->next_in_bucket) {
+                        if (entry->hash == hash && entry->font == font
+                            && entry->color.red == color.red && entry->color.green == color.green
+                            && entry->color.blue == color.blue && entry->color.alpha == color.alpha
+                            && strcmp(entry->text, text) == 0) {
+                                ++g_stats.hits;
+
+                                // It becomes the most recently used entry
+                                lru_unlink(entry);
+                                lru_push_front(entry);
+                                return entry->surface;
+                        }
+                }
+        }
+
+        // Compose the text from the glyphs of the font
+        ++g_stats.misses;
+        ei_surface_t surface = glyph_atlas_create_text_surface(text, font, color);
+        ei_size_t size = hw_surface_get_size(surface);
+        size_t bytes = (size_t) size.width * size.height * 4;
+
+        // Free the least recently used surfaces to respect the budget
+        while (g_least_recent != NULL && g_stats.bytes + bytes > g_budget) {
+                evict_least_recent();
+        }
+
+        // Keep at most one entry per bucket in average
+        if (g_stats.entries >= g_nb_buckets) {
+                grow_buckets();
+        }
+
+        // Insert the new entry. It is kept until the next call, even if it is bigger than the budget.
+        text_entry *entry = malloc(sizeof(text_entry));
+        entry->text = strdup(text);
+        entry->font = font;
+        entry->color = color;
+        entry->hash = hash;
+        entry->surface = surface;
+        entry->bytes = bytes;
+
+        text_entry **bucket = &g_buckets[hash & (g_nb_buckets - 1)];
+        entry->next_in_bucket = *bucket;
+        *bucket = entry;
+        lru_push_front(entry);
+
+        g_stats.bytes += bytes;
+        ++g_stats.entries;
+        return surface;
+}
+
+/**
+ * @brief       Free every cached size.
+ */
+static void forget_all_sizes(void) {
+        if (g_size_buckets == NULL) return;
+
+        for (uint32_t i = 0 ; i < TEXT_CACHE_SIZE_BUCKETS ; ++i) {
+                while (g_size_buckets[i] != NULL) {
+                        size_entry *to_suppr = g_size_buckets[i];
+                        g_size_buckets[i] = to_suppr->next;
+                        free(to_suppr->text);
+                        free(to_suppr);
+                }
+        }
+        g_nb_sizes = 0;
+}
+
+/**
+ * @brief       Return the address of the link to the size of a text in its bucket.
+ *
+ * @param       text        The string of the text
+ * @param       font        The font
+ * @param       hash        The hash of (text, font)
+ *
+ * @return      The address of the link, which is NULL if the size is not cached.
+ */
+static size_entry **find_size(const char *text, ei_font_t font, uint32_t hash) {
+        size_entry **link = &g_size_buckets[hash & (TEXT_CACHE_SIZE_BUCKETS - 1)];
+        while (*link != NULL && ((*link)->hash != hash || (*link)->font != font || strcmp((*link)->text, text) != 0)) {
+                link = &(*link)->next;
+        }
+        return link;
+}
+
+/**
+ * @brief       Computes the size of a text surface given the font and the text. The size is computed
+ *              by \ref hw_text_compute_size only if it is not already in the cache.
+ *
+ * @param       text            The string of the text. Can't be NULL.
+ * @param       font            The font used to render the text. Can't be NULL.
+ * @param       width, height   Addresses where to store the computed width and height of the text surface.
+ */
+void text_cache_compute_size(const char *text, ei_font_t font, int *width, int *height) {
+        if (g_size_buckets == NULL) {
+                g_size_buckets = calloc(TEXT_CACHE_SIZE_BUCKETS, sizeof(size_entry*));
+        }
+
+        // The color is not a part of the key
+        uint32_t hash = hash_key(text, font, (ei_color_t) {0, 0, 0, 0});
+        size_entry **link = find_size(text, font, hash);
+
+        if (*link == NULL) {
+                ++g_stats.size_misses;
+                if (g_nb_sizes >= TEXT_CACHE_MAX_SIZES) {
+                        forget_all_sizes();
+                        link = find_size(text, font, hash);
+                }
+
+                size_entry *entry = malloc(sizeof(size_entry));
+                entry->text = strdup(text);
+                entry->font = font;
+                entry->hash = hash;
+                hw_text_compute_size(text, font, &entry->size.width, &entry->size.height);
+                entry->next = NULL;
+                *link = entry;
+                ++g_nb_sizes;
+        } else {
+                ++g_stats.size_hits;
+        }
+
+        *width = (*link)->size.width;
+        *height = (*link)->size.height;
+}
+
+/**
+ * @brief       Forget the size of a text, when a widget doesn't display it anymore.
+ *
+ * @param       text            The string of the text. Can't be NULL.
+ * @param       font            The font used to render the text.
+ */
+void text_cache_forget_size(const char *text, ei_font_t font) {
+        if (g_size_buckets == NULL) return;
+
+        size_entry **link = find_size(text, font, hash_key(text, font, (ei_color_t) {0, 0, 0, 0}));
+        if (*link != NULL) {
+                size_entry *to_suppr = *link;
+                *link = to_suppr->next;
+                free(to_suppr->text);
+                free(to_suppr);
+                --g_nb_sizes;
+        }
+}
+
+/**
+ * @brief       Free the surfaces rendered with a font and the sizes measured with it. It must be called
+ *              before the font is freed, because a font created later may have the same address.
+ *              The statistics are kept.
+ *
+ * @param       font        The font
+ */
+void text_cache_forget_font(ei_font_t font) {
+        text_entry *entry = g_most_recent;
+        while (entry != NULL) {
+                text_entry *next = entry->less_recent;
+                if (entry->font == font) free_entry(entry);
+                entry = next;
+        }
+
+        if (g_size_buckets == NULL) return;
+        for (uint32_t i = 0 ; i < TEXT_CACHE_SIZE_BUCKETS ; ++i) {
+                size_entry **link = &g_size_buckets[i];
+                while (*link != NULL) {
+                        if ((*link)->font == font) {
+                                size_entry *to_suppr = *link;
+                                *link = to_suppr->next;
+                                free(to_suppr->text);
+                                free(to_suppr);
+                                --g_nb_sizes;
+                        } else {
+                                link = &(*link)->next;
+                        }
+                }
+        }
+}
+
+/**
+ * @brief       Change the memory budget of the cached surfaces. Surfaces are freed if it is exceeded.
+ *
+ * @param       budget      The budget, in bytes. 0 disables the cache.
+ */
+void text_cache_set_budget(size_t budget) {
+        g_budget = budget;
+        while (g_least_recent != NULL && g_stats.bytes > g_budget) {
+                evict_least_recent();
+        }
+}
+
+/**
+ * @brief       Return the statistics of the cache since the beginning of the program.
+ *
+ * @return      The statistics.
+ */
+text_cache_stats_t text_cache_get_stats(void) {
+        return g_stats;
+}
+
+/**
+ * @brief       Free every cached surface and size, for example before freeing a font which has been used.
+ *              The statistics are kept.
+ */
+void text_cache_flush(void) {
+        // Entries freed by the flush are not counted as evictions
+        while (g_least_recent != NULL) {
+                free_entry(g_least_recent);
+        }
+
+        free(g_buckets);
+        g_buckets = NULL;
+        g_nb_buckets = 0;
+
+        forget_all_sizes();
+        free(g_size_buckets);
+        g_size_buckets = NULL;
+}
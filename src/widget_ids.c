@@ -0,0 +1,92 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "widget_ids.h"
+
+// Widgets indexed by their pick_id, NULL for unused ids
+static ei_widget_t **g_widgets = NULL;
+static uint32_t g_size = 0;
+
+// Ids of the destroyed widgets, the last one is given first
+static uint32_t *g_free_ids = NULL;
+static uint32_t g_nb_free_ids = 0;
+static uint32_t g_free_ids_size = 0;
+
+// Id of the next widget when there is no free id
+static uint32_t g_next_id = 1;
+
+/**
+ * @brief       Return an id for a new widget. The ids of the destroyed widgets are used first, so the
+ *              ids stay dense and the pick colors stay small. The id 0 is kept for the root widget.
+ *
+ * @return      The id.
+ */
+uint32_t widget_ids_new(void) {
+        if (g_nb_free_ids) {
+                return g_free_ids[--g_nb_free_ids];
+        }
+        return g_next_id++;
+}
+
+/**
+ * @brief       Store a widget in the table at the index given by its pick_id. The table grows if needed.
+ *
+ * @param       widget      The widget
+ */
+void widget_ids_register(ei_widget_t *widget) {
+        if (widget->pick_id >= g_size) {
+                // The size is doubled, so that registering n widgets costs O(n)
+                uint32_t new_size = g_size ? g_size : WIDGET_IDS_INITIAL_SIZE;
+                while (new_size <= widget->pick_id) {
+                        new_size *= 2;
+                }
+                g_widgets = realloc(g_widgets, new_size * sizeof(ei_widget_t*));
+                memset(g_widgets + g_size, 0, (new_size - g_size) * sizeof(ei_widget_t*));
+                g_size = new_size;
+        }
+        g_widgets[widget->pick_id] = widget;
+}
+
+/**
+ * @brief       Remove a widget from the table, its id is given again by \ref widget_ids_new.
+ *
+ * @param       widget      The widget
+ */
+void widget_ids_forget(ei_widget_t *widget) {
+        if (widget->pick_id >= g_size || g_widgets[widget->pick_id] != widget) return;
+        g_widgets[widget->pick_id] = NULL;
+
+        // The id of the root widget is never given to another widget
+        if (widget->pick_id == 0) return;
+        if (g_nb_free_ids == g_free_ids_size) {
+                g_free_ids_size = g_free_ids_size ? g_free_ids_size * 2 : WIDGET_IDS_INITIAL_SIZE;
+                g_free_ids = realloc(g_free_ids, g_free_ids_size * sizeof(uint32_t));
+        }
+        g_free_ids[g_nb_free_ids++] = widget->pick_id;
+}
+
+/**
+ * @brief       Return the widget which has an id.
+ *
+ * @param       pick_id     The id, read in the picking offscreen for example
+ *
+ * @return      The widget, or NULL if no widget has this id.
+ */
+ei_widget_t *widget_ids_find(uint32_t pick_id) {
+        return pick_id < g_size ? g_widgets[pick_id] : NULL;
+}
+
+/**
+ * @brief       Free the memory used by the table and the free ids. The next id is 1 again.
+ */
+void widget_ids_release(void) {
+        free(g_widgets);
+        g_widgets = NULL;
+        g_size = 0;
+
+        free(g_free_ids);
+        g_free_ids = NULL;
+        g_nb_free_ids = 0;
+        g_free_ids_size = 0;
+        g_next_id = 1;
+}
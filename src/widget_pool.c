@@ -0,0 +1,73 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "widget_pool.h"
+
+/**
+ * @brief       Allocate a new slab and chain all its blocks in the list of free blocks.
+ *
+ * @param       pool        The pool
+ */
+static void add_slab(widget_pool *pool) {
+        size_t nb_blocks = WIDGET_POOL_SLAB_SIZE / pool->block_size;
+        nb_blocks = nb_blocks ? nb_blocks : 1;
+        char *slab = aligned_alloc(WIDGET_POOL_CACHE_LINE, nb_blocks * pool->block_size);
+
+        if (pool->nb_slabs == pool->slabs_size) {
+                pool->slabs_size = pool->slabs_size ? pool->slabs_size * 2 : 8;
+                pool->slabs = realloc(pool->slabs, pool->slabs_size * sizeof(void*));
+        }
+        pool->slabs[pool->nb_slabs++] = slab;
+
+        // The blocks are chained in the order of the memory
+        for (size_t i = nb_blocks ; i > 0 ; --i) {
+                void *block = slab + (i - 1) * pool->block_size;
+                *(void **) block = pool->free_blocks;
+                pool->free_blocks = block;
+        }
+}
+
+/**
+ * @brief       Return a block of the pool, filled with zeros. A new slab is allocated if there is no free block.
+ *
+ * @param       pool        The pool
+ *
+ * @return      The block, aligned on a cache line.
+ */
+void *widget_pool_alloc(widget_pool *pool) {
+        if (pool->free_blocks == NULL) {
+                add_slab(pool);
+        }
+
+        void *block = pool->free_blocks;
+        pool->free_blocks = *(void **) block;
+        memset(block, 0, pool->block_size);
+        return block;
+}
+
+/**
+ * @brief       Give a block back to the pool, it is used by the next allocation.
+ *
+ * @param       pool        The pool which gave the block
+ * @param       block       The block
+ */
+void widget_pool_free(widget_pool *pool, void *block) {
+        *(void **) block = pool->free_blocks;
+        pool->free_blocks = block;
+}
+
+/**
+ * @brief       Free all the slabs of the pool. The blocks which were not given back become invalid.
+ *
+ * @param       pool        The pool
+ */
+void widget_pool_release(widget_pool *pool) {
+        for (uint32_t i = 0 ; i < pool->nb_slabs ; ++i) {
+                free(pool->slabs[i]);
+        }
+        free(pool->slabs);
+        pool->slabs = NULL;
+        pool->nb_slabs = 0;
+        pool->slabs_size = 0;
+        pool->free_blocks = NULL;
+}
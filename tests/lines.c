@@ -9,6 +9,7 @@
 #include "ei_types.h"
 #include "ei_event.h"
 #include "ei_create_button.h"
+#include "ei_application.h"
 
 
 /* test_line --
@@ -266,6 +267,7 @@ void test_draw_text(ei_surface_t surface, ei_rect_t* clipper){
 
         // Write the text and free the font
         ei_draw_text (surface, &where_write_text, "C en Y", font, color, NULL);
+        ei_app_forget_font(font);
         hw_text_font_free(font);
 }
 
@@ -0,0 +1,129 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "ei_application.h"
+#include "ei_event.h"
+#include "ei_draw.h"
+#include "hw_interface.h"
+#include "ei_widget.h"
+
+
+/*
+ * Draws a toplevel which contains a translucent frame, once without the offscreen cache and once with it,
+ * and checks that the window is the same. The application quits by itself, with EXIT_FAILURE if the two
+ * renderings differ.
+ */
+
+static ei_widget_t*	g_window;
+static ei_surface_t	g_uncached;
+static int		g_step		= 0;
+static int		g_nb_differences = -1;
+
+/*
+ * count_differences --
+ *
+ *	Returns the number of pixels which differ between the root window and a copy of it.
+ */
+static int count_differences(ei_surface_t copy)
+{
+        ei_surface_t	root		= ei_app_root_surface();
+        ei_size_t	size		= hw_surface_get_size(root);
+        int		differences	= 0;
+
+        hw_surface_lock(root);
+        hw_surface_lock(copy);
+        uint32_t* root_pixel = (uint32_t*) hw_surface_get_buffer(root);
+        uint32_t* copy_pixel = (uint32_t*) hw_surface_get_buffer(copy);
+        for (int i = 0; i < size.width * size.height; i++)
+                if (root_pixel[i] != copy_pixel[i])
+                        differences++;
+        hw_surface_unlock(copy);
+        hw_surface_unlock(root);
+
+        return differences;
+}
+
+/*
+ * process_app --
+ *
+ *	Callback called on the application events posted by this test. Each one is received after
+ *	the frame drawn before it.
+ */
+ei_bool_t process_app(ei_event_t* event)
+{
+        ei_surface_t root = ei_app_root_surface();
+
+        if (event->type != ei_ev_app)
+                return EI_FALSE;
+
+        if (g_step == 0) {
+                /* Keep the rendering without the cache, then draw the whole window again with it. */
+                g_uncached = hw_surface_create(root, hw_surface_get_size(root), EI_FALSE);
+                ei_copy_surface(g_uncached, NULL, root, NULL, EI_FALSE);
+
+                ei_widget_set_cached(g_window, EI_TRUE);
+                ei_app_invalidate_rect(&ei_app_root_widget()->screen_location);
+                hw_event_post_app(NULL);
+                g_step = 1;
+        } else {
+                g_nb_differences = count_differences(g_uncached);
+                hw_surface_free(g_uncached);
+                ei_app_quit_request();
+        }
+        return EI_TRUE;
+}
+
+/*
+ * ei_main --
+ *
+ *	Main function of the application.
+ */
+int main(int argc, char** argv)
+{
+        ei_size_t	screen_size		= {400, 300};
+        ei_color_t	root_bgcol		= {0x64, 0x6f, 0xb5, 0xff};
+
+        ei_size_t	window_size		= {300, 200};
+        char*		window_title		= "Cached";
+        ei_color_t	window_color		= {0xA0, 0xB0, 0xC0, 0xff};
+        int		window_border_width	= 2;
+        ei_point_t	window_position		= {30, 20};
+
+        ei_widget_t*	frame;
+        ei_size_t	frame_size		= {200, 100};
+        ei_color_t	frame_color		= {0xE0, 0x70, 0x20, 0x80};
+        int		frame_border_width	= 4;
+        ei_relief_t	frame_relief		= ei_relief_raised;
+        char*		frame_title		= "Translucent";
+        ei_color_t	frame_text_color	= {0x00, 0x00, 0x00, 0xff};
+        int		frame_x			= 20;
+        int		frame_y			= 20;
+
+        ei_app_create(screen_size, EI_FALSE);
+        ei_frame_configure(ei_app_root_widget(), NULL, &root_bgcol, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL);
+        ei_event_set_default_handle_func(process_app);
+
+        /* A toplevel, not cached yet, which contains a translucent frame. */
+        g_window = ei_widget_create("toplevel", ei_app_root_widget(), NULL, NULL);
+        ei_toplevel_configure(g_window, &window_size, &window_color, &window_border_width,
+                              &window_title, NULL, NULL, NULL);
+        ei_place(g_window, NULL, &(window_position.x), &(window_position.y), NULL, NULL, NULL, NULL, NULL, NULL);
+
+        frame = ei_widget_create("frame", g_window, NULL, NULL);
+        ei_frame_configure(frame, &frame_size, &frame_color, &frame_border_width, &frame_relief, &frame_title,
+                           NULL, &frame_text_color, NULL, NULL, NULL, NULL);
+        ei_place(frame, NULL, &frame_x, &frame_y, NULL, NULL, NULL, NULL, NULL, NULL);
+
+        /* The first event is received once the first frame is drawn. */
+        hw_event_post_app(NULL);
+        ei_app_run();
+
+        ei_app_free();
+
+        if (g_nb_differences != 0) {
+                printf("The cached rendering differs from the uncached one on %d pixels\n", g_nb_differences);
+                return (EXIT_FAILURE);
+        }
+        printf("The cached rendering is the same as the uncached one\n");
+        return (EXIT_SUCCESS);
+}
@@ -356,6 +356,7 @@ void destroy_notify	(ei_widget_t*		widget)
 
 	free((void*)(g->tile_values));
 	free((void*)(g->tile_widgets));		// The widget themselves are destroyed as children of the toplevel.
+	ei_app_forget_font(g->tile_font);
 	hw_text_font_free(g->tile_font);
 	free((void*)g);
 }